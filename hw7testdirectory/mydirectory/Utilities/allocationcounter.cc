@@ -0,0 +1,41 @@
+#include "allocationcounter.h"
+
+// a plain integer, so each thread's copy needs no constructor and can
+// be counted into from the first allocation the thread makes
+static thread_local LONG allocation_count = 0;
+
+/****************************************************************
+ * Replacements for the global allocation functions.  The array and
+ * 'nothrow' forms of the library go through these two.
+**/
+void* operator new(std::size_t size) {
+  ++allocation_count;
+  if (0 == size) {
+    size = 1;
+  }
+  void* memory = std::malloc(size);
+  while (nullptr == memory) {
+    std::new_handler handler = std::get_new_handler();
+    if (nullptr == handler) {
+      throw std::bad_alloc();
+    }
+    handler();
+    memory = std::malloc(size);
+  }
+  return memory;
+}
+
+void operator delete(void* memory) noexcept {
+  std::free(memory);
+}
+
+/****************************************************************
+ * General functions.
+**/
+/****************************************************************
+ * Returns:
+ *   the number of heap allocations this thread has made so far
+**/
+LONG AllocationCounter::GetCount() {
+  return allocation_count;
+}
@@ -0,0 +1,36 @@
+/****************************************************************
+ * Header for the 'AllocationCounter' class.
+ *
+ * Author/copyright:  Duncan Buell
+ * Used with permission and modified by: Group 4
+ *                                       Erik Akeyson
+ *                                       Matthew Clapp
+ *                                       Harrison Goodman
+ *                                       Andy Michels
+ *                                       Steve Smero
+ * Date: 1 December 2016
+ *
+ * This code counts heap allocations.  Linking 'allocationcounter.o'
+ * replaces the global 'operator new' with one that counts its calls,
+ * for each thread separately, before handing the work to 'malloc'.
+ * A program can then check that a section of code allocates nothing
+ * by reading the count before and after.
+**/
+
+#ifndef ALLOCATIONCOUNTER_H_
+#define ALLOCATIONCOUNTER_H_
+
+#include <cstdlib>
+#include <new>
+
+#include "utils.h"
+
+class AllocationCounter {
+public:
+/****************************************************************
+ * General functions.
+**/
+ static LONG GetCount();
+};
+
+#endif // ALLOCATIONCOUNTER_H_
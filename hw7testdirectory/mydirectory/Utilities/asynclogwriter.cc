@@ -0,0 +1,240 @@
+#include "asynclogwriter.h"
+
+/****************************************************************
+ * Constructor.  The thread is not started until 'Start'.
+ *
+ * Parameters:
+ *   log_stream - the log file, already open
+ *   capacity - the most records the queue holds, rounded up to a
+ *              power of two
+ *   when_full - 'block' to wait for room when the queue is full,
+ *               'drop' to drop the record instead
+**/
+AsyncLogWriter::AsyncLogWriter(std::ofstream& log_stream,
+                               const int capacity,
+                               const std::string when_full)
+  : log_stream_(log_stream), when_full_(when_full),
+    push_position_(0), pop_position_(0), stopping_(true),
+    dropped_bytes_(0), dropped_records_(0), pushed_records_(0),
+    waits_(0) {
+  size_t size = 2;
+  while (size < static_cast<size_t>(capacity)) {
+    size *= 2;
+  }
+  mask_ = size - 1;
+  cells_.reset(new Cell[size]);
+  for (size_t sub = 0; sub < size; ++sub) {
+    cells_[sub].sequence.store(sub, std::memory_order_relaxed);
+  }
+}
+
+/****************************************************************
+ * Destructor, which writes what is queued and stops the thread.
+**/
+AsyncLogWriter::~AsyncLogWriter() {
+  this->Shutdown();
+}
+
+/****************************************************************
+ * Accessors and mutators.
+**/
+/****************************************************************
+ * Returns:
+ *   the bytes in the records dropped because the queue was full
+**/
+LONG AsyncLogWriter::GetDroppedBytes() const {
+  return dropped_bytes_.load();
+}
+
+/****************************************************************
+ * Returns:
+ *   the records dropped because the queue was full
+**/
+LONG AsyncLogWriter::GetDroppedRecords() const {
+  return dropped_records_.load();
+}
+
+/****************************************************************
+ * Returns:
+ *   the records queued for writing
+**/
+LONG AsyncLogWriter::GetPushedRecords() const {
+  return pushed_records_.load();
+}
+
+/****************************************************************
+ * Returns:
+ *   the pushes that had to wait for room in the queue
+**/
+LONG AsyncLogWriter::GetWaits() const {
+  return waits_.load();
+}
+
+/****************************************************************
+ * General functions.
+**/
+/****************************************************************
+ * Function to queue a record for writing.  If the queue is full the
+ * push waits, yielding, until the writer makes room, or else drops
+ * the record, as the writer was made to do.  With no writer running,
+ * before 'Start' or after 'Shutdown', nothing would make room, so a
+ * push that would wait drops the record too.
+ *
+ * Parameters:
+ *   record - the text to write, taken over by the writer
+ * Returns:
+ *   true if the record was queued, false if it was dropped
+**/
+bool AsyncLogWriter::Push(std::string record) {
+  if (this->TryPush(record)) {
+    ++pushed_records_;
+    return true;
+  }
+
+  if ("drop" != when_full_) {
+    ++waits_;
+    while (!stopping_.load()) {
+      if (this->TryPush(record)) {
+        ++pushed_records_;
+        return true;
+      }
+      std::this_thread::yield();
+    }
+  }
+
+  ++dropped_records_;
+  dropped_bytes_ += static_cast<LONG>(record.size());
+  return false;
+}
+
+/****************************************************************
+ * Function to write whatever is queued and stop the thread.  Records
+ * pushed after this are never written.  Calling it again, or without
+ * 'Start', does nothing.
+**/
+void AsyncLogWriter::Shutdown() {
+  stopping_.store(true);
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+/****************************************************************
+ * Function to start the writer thread.  The caller must not write to
+ * the log file itself from now until 'Shutdown'.
+**/
+void AsyncLogWriter::Start() {
+  stopping_.store(false);
+  thread_ = std::thread(&AsyncLogWriter::WriterLoop, this);
+}
+
+/****************************************************************
+ * Usual 'ToString', here the counters.
+**/
+std::string AsyncLogWriter::ToString() const {
+  std::string s = "";
+
+  s += kTag + "records " + Utils::Format(this->GetPushedRecords())
+     + " waits " + Utils::Format(this->GetWaits())
+     + " dropped " + Utils::Format(this->GetDroppedRecords())
+     + " (" + Utils::Format(this->GetDroppedBytes()) + " bytes)\n";
+
+  return s;
+}
+
+/****************************************************************
+ * Function to take the oldest record off the queue.
+ *
+ * Parameters:
+ *   record - set to the record; what it held is lost
+ * Returns:
+ *   false if the queue was empty
+**/
+bool AsyncLogWriter::TryPop(std::string& record) {
+  size_t position = pop_position_.load(std::memory_order_relaxed);
+  Cell* cell = nullptr;
+  while (true) {
+    cell = &cells_[position & mask_];
+    size_t sequence = cell->sequence.load(std::memory_order_acquire);
+    intptr_t difference = static_cast<intptr_t>(sequence)
+                        - static_cast<intptr_t>(position + 1);
+    if (0 == difference) {
+      if (pop_position_.compare_exchange_weak(position, position + 1,
+                                              std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (difference < 0) {
+      return false;
+    } else {
+      position = pop_position_.load(std::memory_order_relaxed);
+    }
+  }
+
+  record.swap(cell->record);
+  cell->record.clear();
+  cell->sequence.store(position + mask_ + 1, std::memory_order_release);
+  return true;
+}
+
+/****************************************************************
+ * Function to put a record on the queue.
+ *
+ * Parameters:
+ *   record - the record, swapped into the queue if there is room
+ * Returns:
+ *   false if the queue was full
+**/
+bool AsyncLogWriter::TryPush(std::string& record) {
+  size_t position = push_position_.load(std::memory_order_relaxed);
+  Cell* cell = nullptr;
+  while (true) {
+    cell = &cells_[position & mask_];
+    size_t sequence = cell->sequence.load(std::memory_order_acquire);
+    intptr_t difference = static_cast<intptr_t>(sequence)
+                        - static_cast<intptr_t>(position);
+    if (0 == difference) {
+      if (push_position_.compare_exchange_weak(position, position + 1,
+                                               std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (difference < 0) {
+      return false;
+    } else {
+      position = push_position_.load(std::memory_order_relaxed);
+    }
+  }
+
+  cell->record.swap(record);
+  cell->sequence.store(position + 1, std::memory_order_release);
+  return true;
+}
+
+/****************************************************************
+ * Function run by the writer thread: writes records as they come,
+ * flushing the log file whenever the queue runs dry, and sleeps
+ * briefly when there is nothing to do.  Once stopping, it empties
+ * the queue before it returns.
+**/
+void AsyncLogWriter::WriterLoop() {
+  std::string record;
+  while (true) {
+    bool wrote = false;
+    while (this->TryPop(record)) {
+      log_stream_.write(record.data(), record.size());
+      wrote = true;
+    }
+    if (wrote) {
+      log_stream_.flush();
+      continue;
+    }
+    if (stopping_.load()) {
+      if (!this->TryPop(record)) {
+        break;
+      }
+      log_stream_.write(record.data(), record.size());
+      continue;
+    }
+    std::this_thread::sleep_for(std::chrono::microseconds(200));
+  }
+  log_stream_.flush();
+}
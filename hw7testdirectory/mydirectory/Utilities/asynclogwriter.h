@@ -0,0 +1,100 @@
+/****************************************************************
+ * Header for the 'AsyncLogWriter' class.
+ *
+ * Author/copyright:  Duncan Buell
+ * Used with permission and modified by: Group 4
+ *                                       Erik Akeyson
+ *                                       Matthew Clapp
+ *                                       Harrison Goodman
+ *                                       Andy Michels
+ *                                       Steve Smero
+ * Date: 1 December 2016
+ *
+ * This code writes records to a log file from a thread of its own,
+ * so that whoever produces the records never waits on the disk.
+ * Records are whole, already formatted strings.  They go through a
+ * bounded lock-free queue (Vyukov's array queue, which any number of
+ * threads may push to) and are written in the order they were pushed.
+ * When the queue is full a push either waits for room, which is the
+ * backpressure, or drops the record and counts it, as chosen when
+ * the writer is made.  'Shutdown' writes whatever is queued and stops
+ * the thread; after it the log file is the caller's again.
+**/
+
+#ifndef ASYNCLOGWRITER_H_
+#define ASYNCLOGWRITER_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "utils.h"
+
+class AsyncLogWriter {
+public:
+/****************************************************************
+ * Constructors and destructors for the class.
+**/
+ AsyncLogWriter(std::ofstream& log_stream, const int capacity,
+                const std::string when_full);
+ virtual ~AsyncLogWriter();
+
+/****************************************************************
+ * Accessors and mutators.
+**/
+ LONG GetDroppedBytes() const;
+ LONG GetDroppedRecords() const;
+ LONG GetPushedRecords() const;
+ LONG GetWaits() const;
+
+/****************************************************************
+ * General functions.
+**/
+ bool Push(std::string record);
+ void Shutdown();
+ void Start();
+ std::string ToString() const;
+
+private:
+ const std::string kTag = "ASYNCLOGWRITER: ";
+
+ // one slot of the queue; 'sequence' says whether the slot is free
+ // for the push with that position or full for the pop with it
+ struct Cell {
+   std::atomic<size_t> sequence;
+   std::string record;
+ };
+
+ std::ofstream& log_stream_;
+ std::string when_full_;
+
+ size_t mask_ = 0;
+ std::unique_ptr<Cell[]> cells_;
+ std::atomic<size_t> push_position_;
+ std::atomic<size_t> pop_position_;
+
+ // set until 'Start' and again by 'Shutdown', whenever there is
+ // no writer thread or it is to finish up
+ std::atomic<bool> stopping_;
+ std::thread thread_;
+
+ std::atomic<LONG> dropped_bytes_;
+ std::atomic<LONG> dropped_records_;
+ std::atomic<LONG> pushed_records_;
+ std::atomic<LONG> waits_;
+
+ bool TryPop(std::string& record);
+ bool TryPush(std::string& record);
+ void WriterLoop();
+
+ // no copies, since the thread belongs to this one
+ AsyncLogWriter(const AsyncLogWriter&);
+ AsyncLogWriter& operator=(const AsyncLogWriter&);
+};
+
+#endif // ASYNCLOGWRITER_H_
@@ -0,0 +1,142 @@
+#include "bufferedoutput.h"
+
+/****************************************************************
+ * Constructor.
+ *
+ * Parameters:
+ *   out_stream - the output file, already open
+ *   log_stream - the log file, already open
+**/
+BufferedOutput::BufferedOutput(std::ofstream& out_stream,
+                               std::ofstream& log_stream)
+  : out_stream_(out_stream), log_stream_(log_stream) {
+}
+
+/****************************************************************
+ * Destructor, which writes out whatever is left.
+**/
+BufferedOutput::~BufferedOutput() {
+  this->Flush();
+}
+
+/****************************************************************
+ * Accessors and mutators.
+**/
+/****************************************************************
+ * Returns:
+ *   the bytes handed to the output and log files so far, counting
+ *   text that went to both once
+**/
+LONG BufferedOutput::GetBytesWritten() const {
+  return bytes_written_;
+}
+
+/****************************************************************
+ * Returns:
+ *   the number of times the buffer has been written out
+**/
+LONG BufferedOutput::GetFlushCount() const {
+  return flush_count_;
+}
+
+/****************************************************************
+ * Function to send the log file's copy of the buffer to a log writer
+ * from now on, or, given null, to write it here again.  Whatever is
+ * buffered is flushed first, so the log stays in order.
+ *
+ * Parameters:
+ *   log_writer - the writer, which must outlive its use here
+**/
+void BufferedOutput::SetLogWriter(AsyncLogWriter* log_writer) {
+  this->Flush();
+  log_writer_ = log_writer;
+}
+
+/****************************************************************
+ * Function to set when the buffer is written out.
+ *
+ * Parameters:
+ *   policy - 'size', 'precinct', or 'exit'
+ *   flush_bytes - for 'size', the buffer is written out once it
+ *                 holds at least this many bytes
+**/
+void BufferedOutput::SetPolicy(const std::string policy,
+                               const size_t flush_bytes) {
+  policy_ = policy;
+  flush_bytes_ = flush_bytes;
+  if ("size" == policy_) {
+    buffer_.reserve(flush_bytes_);
+  }
+}
+
+/****************************************************************
+ * General functions.
+**/
+/****************************************************************
+ * Function to mark the end of a precinct's output, which writes out
+ * the buffer under the 'precinct' policy.
+**/
+void BufferedOutput::EndPrecinct() {
+  if ("precinct" == policy_) {
+    this->Flush();
+  }
+}
+
+/****************************************************************
+ * Function to write the buffer to both files and flush them.  The
+ * output file gets the buffer less the parts for the log only, in as
+ * few writes as there are such parts; the log file gets all of it in
+ * one write, or as one record queued to the log writer.
+**/
+void BufferedOutput::Flush() {
+  if (buffer_.empty()) {
+    return;
+  }
+
+  size_t start = 0;
+  for (auto iter = log_only_.begin(); iter != log_only_.end(); ++iter) {
+    out_stream_.write(buffer_.data() + start, iter->first - start);
+    start = iter->second;
+  }
+  out_stream_.write(buffer_.data() + start, buffer_.size() - start);
+  out_stream_.flush();
+  if (nullptr != log_writer_) {
+    log_writer_->Push(buffer_);
+  } else {
+    log_stream_.write(buffer_.data(), buffer_.size());
+    log_stream_.flush();
+  }
+
+  bytes_written_ += static_cast<LONG>(buffer_.size());
+  ++flush_count_;
+  buffer_.clear();
+  log_only_.clear();
+}
+
+/****************************************************************
+ * Function to write text to both the output and the log file.
+ *
+ * Parameters:
+ *   outstring - the text
+**/
+void BufferedOutput::Write(const std::string& outstring) {
+  buffer_ += outstring;
+  if (("size" == policy_) && (buffer_.size() >= flush_bytes_)) {
+    this->Flush();
+  }
+}
+
+/****************************************************************
+ * Function to write text to the log file only.
+ *
+ * Parameters:
+ *   outstring - the text
+**/
+void BufferedOutput::WriteLog(const std::string& outstring) {
+  size_t start = buffer_.size();
+  buffer_ += outstring;
+  log_only_.push_back(std::make_pair(start, buffer_.size()));
+  if (("size" == policy_) && (buffer_.size() >= flush_bytes_)) {
+    this->Flush();
+  }
+}
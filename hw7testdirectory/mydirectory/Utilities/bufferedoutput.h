@@ -0,0 +1,86 @@
+/****************************************************************
+ * Header for the 'BufferedOutput' class.
+ *
+ * Author/copyright:  Duncan Buell
+ * Used with permission and modified by: Group 4
+ *                                       Erik Akeyson
+ *                                       Matthew Clapp
+ *                                       Harrison Goodman
+ *                                       Andy Michels
+ *                                       Steve Smero
+ * Date: 1 December 2016
+ *
+ * This code collects what a program writes to its output file and
+ * its log file in one buffer and hands it to both files only when the
+ * flush policy says to, instead of flushing both after every write.
+ * The policy is one of
+ *   'size' - when the buffer reaches a set number of bytes
+ *   'precinct' - at the end of every precinct's output
+ *   'exit' - only when the program is done
+ * and the buffer is always written out by 'Flush' and by the
+ * destructor.  Text for the log file only is kept in the same buffer
+ * and skipped when writing the output file.  If a log writer is set,
+ * the log file's copy of the buffer is queued to it instead of being
+ * written here.
+**/
+
+#ifndef BUFFEREDOUTPUT_H_
+#define BUFFEREDOUTPUT_H_
+
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "asynclogwriter.h"
+#include "utils.h"
+
+class BufferedOutput {
+public:
+/****************************************************************
+ * Constructors and destructors for the class.
+**/
+ BufferedOutput(std::ofstream& out_stream, std::ofstream& log_stream);
+ virtual ~BufferedOutput();
+
+/****************************************************************
+ * Accessors and mutators.
+**/
+ LONG GetBytesWritten() const;
+ LONG GetFlushCount() const;
+ void SetLogWriter(AsyncLogWriter* log_writer);
+ void SetPolicy(const std::string policy, const size_t flush_bytes);
+
+/****************************************************************
+ * General functions.
+**/
+ void EndPrecinct();
+ void Flush();
+ void Write(const std::string& outstring);
+ void WriteLog(const std::string& outstring);
+
+private:
+ const std::string kTag = "BUFFEREDOUTPUT: ";
+
+ std::ofstream& out_stream_;
+ std::ofstream& log_stream_;
+ AsyncLogWriter* log_writer_ = nullptr;
+
+ std::string policy_ = "precinct";
+ size_t flush_bytes_ = 1 << 20;
+
+ // everything written since the last flush, and the parts of it, as
+ // (start, end) offsets, that go to the log file only
+ std::string buffer_;
+ std::vector<std::pair<size_t, size_t> > log_only_;
+
+ LONG bytes_written_ = 0;
+ LONG flush_count_ = 0;
+
+ // no copies, since two copies would each write the same text
+ BufferedOutput(const BufferedOutput&);
+ BufferedOutput& operator=(const BufferedOutput&);
+};
+
+#endif // BUFFEREDOUTPUT_H_
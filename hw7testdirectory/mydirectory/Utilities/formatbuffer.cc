@@ -0,0 +1,216 @@
+#include "formatbuffer.h"
+
+/****************************************************************
+ * Constructor.
+**/
+FormatBuffer::FormatBuffer() {
+}
+
+/****************************************************************
+ * Destructor.
+**/
+FormatBuffer::~FormatBuffer() {
+}
+
+/****************************************************************
+ * Accessors and mutators.
+**/
+/****************************************************************
+ * Returns:
+ *   the number of characters in the buffer
+**/
+size_t FormatBuffer::GetSize() const {
+  return buffer_.size();
+}
+
+/****************************************************************
+ * Returns:
+ *   the text built since the last 'Clear'
+**/
+const std::string& FormatBuffer::GetString() const {
+  return buffer_;
+}
+
+/****************************************************************
+ * General functions.
+**/
+/****************************************************************
+ * Functions to append a string as 'Format' would return it.
+ *
+ * Parameters:
+ *   value - the string
+ *   width - the width of the output field, padded on the left
+ *   justify - 'left' to pad on the right instead
+ * Returns:
+ *   this buffer, so appends can be chained
+**/
+FormatBuffer& FormatBuffer::Append(const char* value) {
+  buffer_ += value;
+  return *this;
+}
+
+FormatBuffer& FormatBuffer::Append(const std::string& value) {
+  buffer_ += value;
+  return *this;
+}
+
+FormatBuffer& FormatBuffer::Append(const std::string& value,
+                                   const int width) {
+  AppendPadded(buffer_, value.data(), value.size(), width, false);
+  return *this;
+}
+
+FormatBuffer& FormatBuffer::Append(const std::string& value, const int width,
+                                   const std::string& justify) {
+  AppendPadded(buffer_, value.data(), value.size(), width,
+               "left" == justify);
+  return *this;
+}
+
+/****************************************************************
+ * Functions to append an integer as 'Format' would return it.
+ *
+ * Parameters:
+ *   value - the integer
+ *   width - the width of the output field, padded on the left
+ * Returns:
+ *   this buffer, so appends can be chained
+**/
+FormatBuffer& FormatBuffer::Append(const int value) {
+  AppendInteger(buffer_, value, 0);
+  return *this;
+}
+
+FormatBuffer& FormatBuffer::Append(const int value, const int width) {
+  AppendInteger(buffer_, value, width);
+  return *this;
+}
+
+FormatBuffer& FormatBuffer::Append(const UINT value) {
+  AppendInteger(buffer_, value, 0);
+  return *this;
+}
+
+FormatBuffer& FormatBuffer::Append(const UINT value, const int width) {
+  AppendInteger(buffer_, value, width);
+  return *this;
+}
+
+FormatBuffer& FormatBuffer::Append(const LONG value) {
+  AppendInteger(buffer_, value, 0);
+  return *this;
+}
+
+FormatBuffer& FormatBuffer::Append(const LONG value, const int width) {
+  AppendInteger(buffer_, value, width);
+  return *this;
+}
+
+/****************************************************************
+ * Function to append a 'double' fixed to a given precision, as
+ * 'Format' would return it.
+ *
+ * Parameters:
+ *   value - the 'double'
+ *   width - the width of the output field, padded on the left
+ *   precision - the digits after the point
+ * Returns:
+ *   this buffer, so appends can be chained
+**/
+FormatBuffer& FormatBuffer::Append(const double value, const int width,
+                                   const int precision) {
+  AppendFixed(buffer_, value, width, precision);
+  return *this;
+}
+
+/****************************************************************
+ * Function to empty the buffer, keeping its memory for the next line.
+**/
+void FormatBuffer::Clear() {
+  buffer_.clear();
+}
+
+/****************************************************************
+ * Function to make room for a line of at least the given length, so
+ * that building one that long allocates nothing.
+ *
+ * Parameters:
+ *   bytes - the length to make room for
+**/
+void FormatBuffer::Reserve(const size_t bytes) {
+  buffer_.reserve(bytes);
+}
+
+/****************************************************************
+ * Function to append a 'double' written fixed to a string.  The
+ * largest 'double' fixed has 309 digits before the point, so the
+ * stack buffer only runs short for a precision over 150 or so, and
+ * then 'snprintf' writes it instead.
+ *
+ * Parameters:
+ *   out - the string to append to
+ *   value - the 'double'
+ *   width - the width of the field, padded on the left
+ *   precision - the digits after the point
+**/
+void FormatBuffer::AppendFixed(std::string& out, const double value,
+                               const int width, const int precision) {
+  char text[512];
+  std::to_chars_result result = std::to_chars(text, text + sizeof(text),
+                                              value,
+                                              std::chars_format::fixed,
+                                              precision);
+  if (std::errc() == result.ec) {
+    AppendPadded(out, text, result.ptr - text, width, false);
+    return;
+  }
+
+  int length = std::snprintf(nullptr, 0, "%.*f", precision, value);
+  std::string long_text(length + 1, ' ');
+  std::snprintf(&long_text[0], long_text.size(), "%.*f", precision, value);
+  AppendPadded(out, long_text.data(), length, width, false);
+}
+
+/****************************************************************
+ * Function to append an integer to a string.
+ *
+ * Parameters:
+ *   out - the string to append to
+ *   value - the integer
+ *   width - the width of the field, padded on the left
+**/
+void FormatBuffer::AppendInteger(std::string& out, const LONG value,
+                                 const int width) {
+  char text[24];
+  std::to_chars_result result = std::to_chars(text, text + sizeof(text),
+                                              value);
+  AppendPadded(out, text, result.ptr - text, width, false);
+}
+
+/****************************************************************
+ * Function to append text padded with blanks to a width, as 'setw'
+ * pads it: text as long as the width or longer is appended whole.
+ *
+ * Parameters:
+ *   out - the string to append to
+ *   text - the text
+ *   length - the number of characters in 'text'
+ *   width - the width of the field
+ *   left - true to pad on the right, false to pad on the left
+**/
+void FormatBuffer::AppendPadded(std::string& out, const char* text,
+                                const size_t length, const int width,
+                                const bool left) {
+  size_t padding = 0;
+  if ((width > 0) && (static_cast<size_t>(width) > length)) {
+    padding = static_cast<size_t>(width) - length;
+  }
+
+  if (!left) {
+    out.append(padding, ' ');
+  }
+  out.append(text, length);
+  if (left) {
+    out.append(padding, ' ');
+  }
+}
@@ -0,0 +1,85 @@
+/****************************************************************
+ * Header for the 'FormatBuffer' class.
+ *
+ * Author/copyright:  Duncan Buell
+ * Used with permission and modified by: Group 4
+ *                                       Erik Akeyson
+ *                                       Matthew Clapp
+ *                                       Harrison Goodman
+ *                                       Andy Michels
+ *                                       Steve Smero
+ * Date: 1 December 2016
+ *
+ * This code builds lines of formatted numbers and strings by appending
+ * to one buffer that is kept from line to line, so that once the buffer
+ * has grown to the longest line no more memory is allocated.  Numbers
+ * are converted with 'std::to_chars', without a stream.
+ *
+ * Each 'Append' takes the same arguments as the 'Utils::Format' of the
+ * same type and adds exactly the text that 'Format' returns:
+ *   a width pads with blanks on the left, or on the right for a string
+ *     justified 'left', and never cuts anything off
+ *   a 'double' with a precision is written fixed with that many digits
+ *     after the point, rounded as 'printf' rounds
+ * 'Utils::Format' is itself built on the static 'Append' functions.
+**/
+
+#ifndef FORMATBUFFER_H_
+#define FORMATBUFFER_H_
+
+#include <charconv>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include "utils.h"
+
+class FormatBuffer {
+public:
+/****************************************************************
+ * Constructors and destructors for the class.
+**/
+ FormatBuffer();
+ virtual ~FormatBuffer();
+
+/****************************************************************
+ * Accessors and mutators.
+**/
+ size_t GetSize() const;
+ const std::string& GetString() const;
+
+/****************************************************************
+ * General functions.
+**/
+ FormatBuffer& Append(const char* value);
+ FormatBuffer& Append(const std::string& value);
+ FormatBuffer& Append(const std::string& value, const int width);
+ FormatBuffer& Append(const std::string& value, const int width,
+                      const std::string& justify);
+ FormatBuffer& Append(const int value);
+ FormatBuffer& Append(const int value, const int width);
+ FormatBuffer& Append(const UINT value);
+ FormatBuffer& Append(const UINT value, const int width);
+ FormatBuffer& Append(const LONG value);
+ FormatBuffer& Append(const LONG value, const int width);
+ FormatBuffer& Append(const double value, const int width,
+                      const int precision);
+ void Clear();
+ void Reserve(const size_t bytes);
+
+ static void AppendFixed(std::string& out, const double value,
+                         const int width, const int precision);
+ static void AppendInteger(std::string& out, const LONG value,
+                           const int width);
+ static void AppendPadded(std::string& out, const char* text,
+                          const size_t length, const int width,
+                          const bool left);
+
+private:
+ // no 'kTag', which as a const member would keep buffers, and the
+ // classes holding them, from being assigned
+ std::string buffer_;
+};
+
+#endif // FORMATBUFFER_H_
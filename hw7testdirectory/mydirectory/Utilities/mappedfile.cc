@@ -0,0 +1,112 @@
+#include "mappedfile.h"
+
+/****************************************************************
+ * Constructor.
+**/
+MappedFile::MappedFile() {
+}
+
+/****************************************************************
+ * Destructor.
+**/
+MappedFile::~MappedFile() {
+  this->Close();
+}
+
+/****************************************************************
+ * Accessors and mutators.
+**/
+/****************************************************************
+ * Returns:
+ *   the first byte of the mapped file, or null if nothing is mapped
+**/
+const char* MappedFile::GetData() const {
+  return data_;
+}
+
+/****************************************************************
+ * Returns:
+ *   the size of the mapped file in bytes
+**/
+size_t MappedFile::GetSize() const {
+  return size_;
+}
+
+/****************************************************************
+ * General functions.
+**/
+/****************************************************************
+ * Function to unmap the file, if one is mapped.
+**/
+void MappedFile::Close() {
+  if ((nullptr != data_) && (size_ > 0)) {
+    munmap(const_cast<char*>(data_), size_);
+  }
+  data_ = nullptr;
+  size_ = 0;
+}
+
+/****************************************************************
+ * Function to map a file read-only.
+ *
+ * Unlike 'Utils::FileOpen' this does not stop the program if the
+ * file cannot be opened, since callers use it for files that may
+ * legitimately be missing, such as caches.  An empty file maps to
+ * no data and a size of zero.
+ *
+ * Parameters:
+ *   filename - the name of the file to map
+ * Returns:
+ *   true if the file was mapped
+**/
+bool MappedFile::Open(const std::string filename) {
+  this->Close();
+
+  int descriptor = open(filename.c_str(), O_RDONLY);
+  if (descriptor < 0) {
+    return false;
+  }
+
+  struct stat status;
+  if (0 != fstat(descriptor, &status)) {
+    close(descriptor);
+    return false;
+  }
+
+  size_ = static_cast<size_t>(status.st_size);
+  if (size_ > 0) {
+    void* mapping = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE,
+                         descriptor, 0);
+    if (MAP_FAILED == mapping) {
+      close(descriptor);
+      size_ = 0;
+      return false;
+    }
+    data_ = static_cast<const char*>(mapping);
+  }
+  close(descriptor);
+
+  return true;
+}
+
+/****************************************************************
+ * Function to get the time a file was last modified, to the
+ * nanosecond so that files written within the same second still
+ * compare correctly.
+ *
+ * Parameters:
+ *   filename - the name of the file
+ *   nanoseconds - set to the modification time since the epoch
+ * Returns:
+ *   true if the file exists
+**/
+bool MappedFile::GetModifiedTime(const std::string filename,
+                                 LONG& nanoseconds) {
+  struct stat status;
+  if (0 != stat(filename.c_str(), &status)) {
+    return false;
+  }
+  nanoseconds = static_cast<LONG>(status.st_mtim.tv_sec) * 1000000000
+              + static_cast<LONG>(status.st_mtim.tv_nsec);
+  return true;
+}
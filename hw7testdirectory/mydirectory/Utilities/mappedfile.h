@@ -0,0 +1,63 @@
+/****************************************************************
+ * Header for the 'MappedFile' class.
+ *
+ * Author/copyright:  Duncan Buell
+ * Used with permission and modified by: Group 4
+ *                                       Erik Akeyson
+ *                                       Matthew Clapp
+ *                                       Harrison Goodman
+ *                                       Andy Michels
+ *                                       Steve Smero
+ * Date: 1 December 2016
+ *
+ * This code maps a whole file read-only into memory so that it can
+ * be read in place, without copying it through a stream.
+**/
+
+#ifndef MAPPEDFILE_H_
+#define MAPPEDFILE_H_
+
+#include <cstddef>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "utils.h"
+
+class MappedFile {
+public:
+/****************************************************************
+ * Constructors and destructors for the class.
+**/
+ MappedFile();
+ virtual ~MappedFile();
+
+/****************************************************************
+ * Accessors and mutators.
+**/
+ const char* GetData() const;
+ size_t GetSize() const;
+
+/****************************************************************
+ * General functions.
+**/
+ void Close();
+ bool Open(const std::string filename);
+
+ static bool GetModifiedTime(const std::string filename, LONG& nanoseconds);
+
+private:
+ const std::string kTag = "MAPPEDFILE: ";
+
+ const char* data_ = nullptr;
+ size_t size_ = 0;
+
+ // no copies, since the destructor unmaps
+ MappedFile(const MappedFile&);
+ MappedFile& operator=(const MappedFile&);
+};
+
+#endif // MAPPEDFILE_H_
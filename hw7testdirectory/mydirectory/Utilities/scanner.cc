@@ -4,9 +4,6 @@
  * Constructor.
 **/
 Scanner::Scanner() {
-  scanline_.OpenString("");
-
-  std::string the_next = scanline_.Next();
 }
 
 /****************************************************************
@@ -23,120 +20,71 @@ Scanner::~Scanner() {
  * General functions.
 **/
 /****************************************************************
- * Function to close the stream.
+ * Function to close the file.
 **/
 void Scanner::Close() {
-  Utils::FileClose(local_stream_);
+  mapped_.Close();
+  position_ = 0;
+  line_end_ = 0;
+  next_line_ = 0;
 }
 
 /****************************************************************
  * Function for testing for more data in the file.
  *
+ * If the current line has no more tokens this moves on to the next
+ * line that has one, so that 'Next' and the rest read from it.
+ *
  * Returns:
  *   true if there is a 'next' of anything in the file. 
 **/
 bool Scanner::HasNext() {
-  bool return_value = true;
-
-//  std::cout << TAG << "enter HasNext" << std::endl;
-
-  if (scanline_.HasNext()) {
-//    std::cout << TAG << "scanLine HasNext true" << std::endl;
-//    std::cout << TAG << "leave HasNext" << std::endl;
-    return true;
+  while (!this->HasTokenOnLine()) {
+    if (!this->StartNextLine()) {
+      return false;
+    }
   }
-  else {
-    bool got_answer = false;
-    while (!got_answer) {
-//      std::cout << TAG << "scanLine HasNext false" << std::endl;
-      std::string next_line = this->NextLine();
-//      std::cout << TAG << "next line is " << NextLine << std::endl;
-      next_line = Utils::TrimBlanks(next_line);
-      if (0 == next_line.length()) {
-//        std::cout << TAG << "next line exists and is blank " << NextLine << std::endl;
-//        std::cout << TAG << "leave HasNext" << std::endl;
-//        return false;
-        if (local_stream_.eof()) return false;
-      }
-      else {
-//        std::cout << TAG << "next line exists and is not blank " << NextLine << std::endl;
-        scanline_.OpenString(next_line);
-//        std::cout << TAG << "leave HasNext" << std::endl;
-        got_answer = true;
-        return true;
-      }
-    } // while (!got_answer)
-
-  }
-
-//  std::cout << TAG << "leave HasNext" << std::endl;
-
-  return return_value;
+  return true;
 } // bool Scanner::HasNext()
 
 /****************************************************************
  * Function for returning a next token as a string.
  *
- * The definition of a 'token' is anything other than whitespace.
- * In this implementation, whitespace includes newline, carriage
- * return, and tab.
- *
- * We have two booleans to keep track of three states:
- *   have not yet found NWS (token beginning)
- *   have not yet found WS after finding NWS (token end)
- *
- * We read a character.
- * If there is no next character to be read
- *    Then we throw an error
- * While we are not at end of file:
- *    Test the char for NWS
- *    If NWS
- *       Set the bool that we have found NWS
- *       If we have found WS after NWS, 
- *          put back the NWS--it's the start of the next token
- *          break
- *       Else append the NWS to the token
- *    Else (i.e., if WS)
- *       If we have ever found NWS
- *          Set the bool that we have found WS after NWS
- *    Read the next character.
+ * The definition of a 'token' is anything other than whitespace,
+ * which is what 'isspace' says it is.  Only the current line is
+ * read; if it has no more tokens the token is empty.
  *
  * Returns:
  *   the 'string' version of the next token.
 **/
 std::string Scanner::Next() {
+  const char* begin = nullptr;
+  const char* end = nullptr;
+  this->TakeToken(begin, end);
 
-  std::string return_value = scanline_.Next();
-
-  return return_value;
+  return std::string(begin, end);
 } // string Scanner::Next()
 
-/****************************************************************
- * Function for returning a next character.
- *
- * Returns:
- *   the next character in the file
-char Scanner::nextChar()
-{
-  char c = this->localStream.get();
-  return c;
-} // char Scanner::nextChar()
-**/
-
 /****************************************************************
  * Function for returning a next 'double'.
  *
- * This function does not trap errors. Errors in converting from
- * 'string' to 'double' simply cause crashing.
+ * The token is converted in place.  Anything 'from_chars' will not
+ * take whole, such as a leading '+', is copied and given to 'atof'
+ * as before, so a bad token still gives whatever 'atof' makes of it.
  *
  * Returns:
  *   the next token in the file, parsed as a 'double'
 **/
 double Scanner::NextDouble() {
-  double return_value;
-
-  std::string next_token = this->Next();
-  return_value = atof(next_token.c_str());
+  const char* begin = nullptr;
+  const char* end = nullptr;
+  this->TakeToken(begin, end);
+
+  double return_value = 0.0;
+  std::from_chars_result result = std::from_chars(begin, end, return_value);
+  if ((std::errc() != result.ec) || (end != result.ptr)) {
+    return_value = atof(std::string(begin, end).c_str());
+  }
 
   return return_value;
 } // double Scanner::NextDouble()
@@ -144,20 +92,23 @@ double Scanner::NextDouble() {
 /****************************************************************
  * Function for returning the next 'int' value.
  *
- * This function does not really trap errors. Errors in converting
- * from 'string' to 'int' simply cause crashing.
+ * The token is converted in place.  One that 'from_chars' will not
+ * take whole goes to 'Utils::StringToInteger', which reports it as
+ * before.
  *
  * Returns:
  *   the next token in the file, parsed as an 'int'
 **/
 int Scanner::NextInt() {
-  int return_value;
-  std::string next_token;
-
-  return_value = 0;
-  next_token = this->Next();
-
-  return_value = Utils::StringToInteger(next_token);
+  const char* begin = nullptr;
+  const char* end = nullptr;
+  this->TakeToken(begin, end);
+
+  int return_value = 0;
+  std::from_chars_result result = std::from_chars(begin, end, return_value);
+  if ((std::errc() != result.ec) || (end != result.ptr)) {
+    return_value = Utils::StringToInteger(std::string(begin, end));
+  }
 
   return return_value;
 } // int Scanner::NextInt()
@@ -165,58 +116,131 @@ int Scanner::NextInt() {
 /****************************************************************
  * Function for returning the rest of the line as a string.
  *
- * This is just a wrapper for the 'getline' function.
- * Note that this does not trim whitespace at the beginning
- * or at the end.
+ * If the current line has tokens left this is the rest of it, and
+ * otherwise it is the whole of the next line, as 'getline' would
+ * read it.  This does not trim whitespace at the beginning or at the
+ * end.
  *
  * Returns:
  *   the 'string' version of the rest of the line
 **/
 std::string Scanner::NextLine() {
-  std::string return_value;
-
-//  std::cout << TAG << "enter NextLine" << std::endl;
-
-  if (scanline_.HasNext())
-  {
-    return_value = scanline_.NextLine();
-//    std::cout << TAG << "scanLine hasNext " << return_value << std::endl;
-  }
-  else
-  {
-    getline(local_stream_, return_value);
-//    std::cout << TAG << "scanLine needed new line " << return_value << std::endl;
+  if (!this->HasTokenOnLine()) {
+    if (!this->StartNextLine()) {
+      return "";
+    }
   }
 
-//  std::cout << TAG << "leave NextLine" << std::endl;
+  std::string return_value(mapped_.GetData() + position_,
+                           line_end_ - position_);
+  position_ = line_end_;
   return return_value;
 } // string Scanner::NextLine()
 
 /****************************************************************
  * Function for returning the next 'LONG' value.
  *
- * This function does not really trap errors. Errors in converting
- * from 'string' to 'LONG' simply cause crashing.
+ * As with 'NextInt', tokens that 'from_chars' will not take, and
+ * negative ones, which 'Utils::StringToLONG' has never accepted, go
+ * to 'Utils::StringToLONG'.
  *
  * Returns:
  *   the next token in the file, parsed as an 'LONG'
 **/
 LONG Scanner::NextLONG() {
-  LONG return_value;
-  std::string next_token;
-
-  return_value = 0;
-  next_token = this->Next();
-
-  return_value = Utils::StringToLONG(next_token);
+  const char* begin = nullptr;
+  const char* end = nullptr;
+  this->TakeToken(begin, end);
+
+  LONG return_value = 0;
+  std::from_chars_result result = std::from_chars(begin, end, return_value);
+  if ((std::errc() != result.ec) || (end != result.ptr)
+      || ((begin != end) && ('-' == *begin))) {
+    return_value = Utils::StringToLONG(std::string(begin, end));
+  }
 
   return return_value;
 } // LONG Scanner::NextLONG()
 
 /****************************************************************
- * Function to open a file as a 'Scanner'.
+ * Function to open a file as a 'Scanner'.  As with 'Utils::FileOpen',
+ * a file that cannot be opened stops the program.
 **/
 void Scanner::OpenFile(std::string filename) {
-  Utils::FileOpen(local_stream_, filename);
+  std::cout << kTag << "open the input file '" << filename << "'\n";
+  this->Close();
+  if (!mapped_.Open(filename)) {
+    std::cout << kTag << "open failed for '" << filename << "'\n";
+    exit(0);
+  }
+  std::cout << kTag << "open succeeded for '" << filename << "'\n";
+}
+
+/****************************************************************
+ * Function to skip whitespace on the current line.
+ *
+ * Returns:
+ *   true if a token is left on the current line
+**/
+bool Scanner::HasTokenOnLine() {
+  const char* data = mapped_.GetData();
+  while ((position_ < line_end_)
+         && isspace(static_cast<unsigned char>(data[position_]))) {
+    ++position_;
+  }
+  return position_ < line_end_;
+}
+
+/****************************************************************
+ * Function to make the next line of the file the current line.
+ *
+ * Returns:
+ *   false if there are no more lines
+**/
+bool Scanner::StartNextLine() {
+  size_t size = mapped_.GetSize();
+  if (next_line_ >= size) {
+    position_ = size;
+    line_end_ = size;
+    return false;
+  }
+
+  const char* data = mapped_.GetData();
+  position_ = next_line_;
+  const void* newline = memchr(data + position_, '\n', size - position_);
+  if (nullptr == newline) {
+    line_end_ = size;
+    next_line_ = size;
+  } else {
+    line_end_ = static_cast<const char*>(newline) - data;
+    next_line_ = line_end_ + 1;
+  }
+  return true;
 }
 
+/****************************************************************
+ * Function to find the next token on the current line and move past
+ * it.  With no token left, 'begin' and 'end' are equal.
+ *
+ * Parameters:
+ *   begin - set to the first character of the token
+ *   end - set to just past the last character of the token
+**/
+void Scanner::TakeToken(const char*& begin, const char*& end) {
+  this->HasTokenOnLine();
+
+  const char* data = mapped_.GetData();
+  size_t start = position_;
+  while ((position_ < line_end_)
+         && !isspace(static_cast<unsigned char>(data[position_]))) {
+    ++position_;
+  }
+
+  // an empty file maps to no data at all, and an empty token then
+  // has to point somewhere
+  if (nullptr == data) {
+    data = "";
+  }
+  begin = data + start;
+  end = data + position_;
+}
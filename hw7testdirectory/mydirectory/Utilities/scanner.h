@@ -4,19 +4,27 @@
  * Author/copyright:  Duncan Buell
  * Date: 8 May 2016
  *
+ * The file is mapped into memory and read in place: tokens are found
+ * by moving offsets along the mapped bytes and numbers are converted
+ * straight from them with 'std::from_chars', so reading a number
+ * copies nothing.  As before, 'HasNext' moves on to the next line with
+ * a token on it, blank lines skipped, and 'Next' and the other token
+ * functions read only from that line.
 **/
 
 #ifndef SCANNER_H_
 #define SCANNER_H_
 
+#include <charconv>
 #include <iostream>
 #include <fstream>
 #include <cstdlib>
+#include <cstring>
 #include <string>
 #include <vector>
 
 #include "utils.h"
-#include "scanline.h"
+#include "mappedfile.h"
 
 #define NDEBUG
 #include <cassert>
@@ -31,11 +39,6 @@ public:
  Scanner();
  virtual ~Scanner();
 
-/****************************************************************
- * Variables.
-**/
- std::ifstream local_stream_;
-
 /****************************************************************
  * General functions.
 **/
@@ -51,7 +54,18 @@ public:
 private:
  const std::string kTag = "SCANNER: ";
 
- ScanLine scanline_;
+ MappedFile mapped_;
+
+ // offsets into the mapped file: the next character to read, the end
+ // of the line it is on (its newline, or the end of the file), and
+ // the start of the line after
+ size_t position_ = 0;
+ size_t line_end_ = 0;
+ size_t next_line_ = 0;
+
+ bool HasTokenOnLine();
+ bool StartNextLine();
+ void TakeToken(const char*& begin, const char*& end);
 };
 
 #endif // SCANNER_H_
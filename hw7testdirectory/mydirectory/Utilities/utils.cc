@@ -1,11 +1,12 @@
 #include "utils.h"
+#include "formatbuffer.h"
 
 static const std::string kTag = "UTILS: ";
 static const std::string WHITESPACE = " \n\t\r";
 
 std::ofstream Utils::log_stream;
-std::ostringstream Utils::oss;
-std::stringstream Utils::ss;
+thread_local std::ostringstream Utils::oss;
+thread_local std::stringstream Utils::ss;
 
 /****************************************************************
  * Constructor.
@@ -41,6 +42,26 @@ void Utils::CheckArgs(const int howMany, const int argc,
   }
 }
 
+/****************************************************************
+ * Check for at least the required number of arguments, allowing
+ * optional arguments to follow the required ones.
+ *
+ * Parameters:
+ *   howMany - the number of required arguments
+ *   argc - the usual 'argc' of command line information
+ *   argv - the usual 'argv' of command line information
+ *   usage - the 'usage' message to display on error
+ * Return: none
+**/
+void Utils::CheckArgsAtLeast(const int howMany, const int argc,
+                             char *argv[], const std::string usage) {
+  if(argc < howMany + 1)
+  {
+    std::cout << kTag << "usage: " << argv[0] << " " << usage << std::endl;
+    exit(1);
+  }
+}
+
 /****************************************************************
  * Close an input stream.
  *
@@ -210,6 +231,12 @@ void Utils::LogFileOpen(std::string filename) {
  *   'double' to a 'string' of 'width'
  *   'double' to a 'string' of 'width' and 'precision'
  *
+ * All but the 'double' without a precision are written by the
+ * 'FormatBuffer' functions, with 'std::to_chars' and no stream.  The
+ * justification no longer carries over from one call to the next as
+ * it did with the shared stream; it is right unless 'left' is asked.
+ * Code building a long line should append to a 'FormatBuffer' rather
+ * than add up the strings these return.
 **/
 /****************************************************************
  * String-ify a 'char*' array, without width formatting.
@@ -219,9 +246,7 @@ void Utils::LogFileOpen(std::string filename) {
  * Return: the string-ified version of 'value'
 **/
 std::string Utils::Format(const char* value) {
-  Utils::oss.str("");
-  Utils::oss << std::string(value);
-  return oss.str();
+  return std::string(value);
 }
 
 /****************************************************************
@@ -234,9 +259,9 @@ std::string Utils::Format(const char* value) {
  * Return: the string-ified version of 'value'
 **/
 std::string Utils::Format(const char* value, const int width) {
-  Utils::oss.str("");
-  Utils::oss << std::setw(width) << std::string(value);
-  return oss.str();
+  std::string s = "";
+  FormatBuffer::AppendPadded(s, value, strlen(value), width, false);
+  return s;
 }
 
 /****************************************************************
@@ -251,23 +276,10 @@ std::string Utils::Format(const char* value, const int width) {
 **/
 std::string Utils::Format(const char* value, const int width,
                           const std::string justify) {
-  Utils::oss.str("");
-
-  if("left" == justify)
-  {
-    Utils::oss.setf(std::ios::left, std::ios::adjustfield);
-    Utils::oss << std::setw(width) << std::string(value);
-  }
-  else if("right" == justify)
-  {
-    Utils::oss.setf(std::ios::right, std::ios::adjustfield);
-    Utils::oss << std::setw(width) << std::string(value);
-  }
-  else
-  {
-    Utils::oss << std::setw(width) << std::string(value);
-  }
-  return oss.str();
+  std::string s = "";
+  FormatBuffer::AppendPadded(s, value, strlen(value), width,
+                             "left" == justify);
+  return s;
 }
 
 /****************************************************************
@@ -292,9 +304,9 @@ std::string Utils::Format(const std::string value) {
  * Return: the string-ified version of 'value'
 **/
 std::string Utils::Format(const std::string value, const int width) {
-  Utils::oss.str("");
-  Utils::oss << std::setw(width) << value;
-  return oss.str();
+  std::string s = "";
+  FormatBuffer::AppendPadded(s, value.data(), value.size(), width, false);
+  return s;
 }
 
 /****************************************************************
@@ -309,22 +321,10 @@ std::string Utils::Format(const std::string value, const int width) {
 **/
 std::string Utils::Format(const std::string value, const int width,
                           const std::string justify) {
-  Utils::oss.str("");
-  if("left" == justify)
-  {
-    Utils::oss.setf(std::ios::left, std::ios::adjustfield);
-    Utils::oss << std::setw(width) << value;
-  }
-  else if("right" == justify)
-  {
-    Utils::oss.setf(std::ios::right, std::ios::adjustfield);
-    Utils::oss << std::setw(width) << value;
-  }
-  else
-  {
-    Utils::oss << std::setw(width) << value;
-  }
-  return oss.str();
+  std::string s = "";
+  FormatBuffer::AppendPadded(s, value.data(), value.size(), width,
+                             "left" == justify);
+  return s;
 }
 
 /****************************************************************
@@ -336,9 +336,9 @@ std::string Utils::Format(const std::string value, const int width,
  * Return: the string-ified version of 'value'
 **/
 std::string Utils::Format(const short value) {
-  Utils::oss.str("");
-  Utils::oss << value;
-  return oss.str();
+  std::string s = "";
+  FormatBuffer::AppendInteger(s, value, 0);
+  return s;
 }
 
 /****************************************************************
@@ -351,10 +351,9 @@ std::string Utils::Format(const short value) {
  * Return: the string-ified version of 'value'
 **/
 std::string Utils::Format(const short value, const int width) {
-  Utils::oss.str("");
-  Utils::oss.setf(std::ios::right, std::ios::adjustfield);
-  Utils::oss << std::setw(width) << value;
-  return oss.str();
+  std::string s = "";
+  FormatBuffer::AppendInteger(s, value, width);
+  return s;
 }
 
 /****************************************************************
@@ -366,9 +365,9 @@ std::string Utils::Format(const short value, const int width) {
  * Return: the string-ified version of 'value'
 **/
 std::string Utils::Format(const int value) {
-  Utils::oss.str("");
-  Utils::oss << value;
-  return oss.str();
+  std::string s = "";
+  FormatBuffer::AppendInteger(s, value, 0);
+  return s;
 }
 
 /****************************************************************
@@ -381,10 +380,9 @@ std::string Utils::Format(const int value) {
  * Return: the string-ified version of 'value'
 **/
 std::string Utils::Format(const int value, const int width) {
-  Utils::oss.str("");
-  Utils::oss.setf(std::ios::right, std::ios::adjustfield);
-  Utils::oss << std::setw(width) << value;
-  return oss.str();
+  std::string s = "";
+  FormatBuffer::AppendInteger(s, value, width);
+  return s;
 }
 
 /****************************************************************
@@ -396,9 +394,9 @@ std::string Utils::Format(const int value, const int width) {
  * Return: the string-ified version of 'value'
 **/
 std::string Utils::Format(const UINT value) {
-  Utils::oss.str("");
-  Utils::oss << value;
-  return oss.str();
+  std::string s = "";
+  FormatBuffer::AppendInteger(s, value, 0);
+  return s;
 }
 
 /****************************************************************
@@ -411,10 +409,9 @@ std::string Utils::Format(const UINT value) {
  * Return: the string-ified version of 'value'
 **/
 std::string Utils::Format(const UINT value, const int width) {
-  Utils::oss.str("");
-  Utils::oss.setf(std::ios::right, std::ios::adjustfield);
-  Utils::oss << std::setw(width) << value;
-  return oss.str();
+  std::string s = "";
+  FormatBuffer::AppendInteger(s, value, width);
+  return s;
 }
 
 /****************************************************************
@@ -426,9 +423,9 @@ std::string Utils::Format(const UINT value, const int width) {
  * Return: the string-ified version of 'value'
 **/
 std::string Utils::Format(const LONG value) {
-  Utils::oss.str("");
-  Utils::oss << value;
-  return oss.str();
+  std::string s = "";
+  FormatBuffer::AppendInteger(s, value, 0);
+  return s;
 }
 
 /****************************************************************
@@ -441,11 +438,9 @@ std::string Utils::Format(const LONG value) {
  * Return: the string-ified version of 'value'
 **/
 std::string Utils::Format(const LONG value, const int width) {
-  int localWidth = static_cast<int>(width);
-  Utils::oss.str("");
-  Utils::oss.setf(std::ios::right, std::ios::adjustfield);
-  Utils::oss << std::setw(localWidth) << value;
-  return oss.str();
+  std::string s = "";
+  FormatBuffer::AppendInteger(s, value, width);
+  return s;
 }
 
 /****************************************************************
@@ -498,12 +493,9 @@ std::string Utils::Format(const double value, const int width) {
 **/
 std::string Utils::Format(const double value, const int width,
                           const int precision) {
-  Utils::oss.str("");
-  Utils::oss << std::fixed << std::setprecision(precision) << std::setw(width)
-             << value;
-
-  std::string returnString = Utils::Format(oss.str(), width, "right");
-  return returnString;
+  std::string s = "";
+  FormatBuffer::AppendFixed(s, value, width, precision);
+  return s;
 }
 
 /****************************************************************
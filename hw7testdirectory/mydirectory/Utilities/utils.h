@@ -42,8 +42,10 @@ public:
  static std::ofstream log_stream;
 
 //  static stringstream utilsss(stringstream::in | stringstream::out);
- static std::stringstream ss;
- static std::ostringstream oss;
+// one formatting stream per thread so 'Format' can be called from
+// simulation threads running side by side
+ static thread_local std::stringstream ss;
+ static thread_local std::ostringstream oss;
 
 /****************************************************************
  * Constructors and destructors for the class. 
@@ -56,6 +58,8 @@ public:
 **/
  static void CheckArgs(const int how_many, const int argc,
                        char *argv[], const std::string usage);
+ static void CheckArgsAtLeast(const int how_many, const int argc,
+                              char *argv[], const std::string usage);
 
 /****************************************************************
  * file open and close functions
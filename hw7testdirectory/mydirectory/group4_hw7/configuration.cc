@@ -19,6 +19,33 @@
 
 static const string kTag = "CONFIG: ";
 
+/****************************************************************
+ * Layout of the binary service times file: this header, then 'count'
+ * 32-bit times, then a 32-bit checksum of the times.  The header is
+ * sixteen bytes so the times that follow are aligned.
+**/
+static const char kServiceCacheMagic[8] = {'S', 'V', 'C', 'T',
+                                           'I', 'M', 'E', 'S'};
+static const uint32_t kServiceCacheVersion = 1;
+
+struct ServiceCacheHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t count;
+};
+
+/****************************************************************
+ * FNV-1a over the times a word at a time, which is plenty to catch a
+ * truncated or damaged file.
+**/
+static uint32_t ServiceCacheChecksum(const int32_t *times, uint32_t count) {
+  uint32_t hash = 2166136261u;
+  for (uint32_t sub = 0; sub < count; ++sub) {
+    hash = (hash ^ static_cast<uint32_t>(times[sub])) * 16777619u;
+  }
+  return hash;
+}
+
 /****************************************************************
  * Constructor.
 **/
@@ -81,12 +108,280 @@ void Configuration::ReadConfiguration(Scanner& instream) {
     arrival_fractions_.push_back(input);
   }
 
+  this->ReadServiceTimes();
+  service_table_.Build(actual_service_times_);
+}
+
+/****************************************************************
+* Function 'ReadServiceTimes'
+*
+* Reads the measured voting times.  Parsing the text file is most of
+* the start-up time of a short run, so the times are also kept in a
+* binary file that is mapped and checked instead.  The binary file is
+* rebuilt from the text whenever the text is newer or the binary file
+* is missing or fails its checks.
+**/
+void Configuration::ReadServiceTimes() {
+  string cache_filename = service_times_filename_ + ".bin";
+
+  LONG text_time = 0;
+  LONG cache_time = 0;
+  bool have_text = MappedFile::GetModifiedTime(service_times_filename_,
+                                               text_time);
+  bool have_cache = MappedFile::GetModifiedTime(cache_filename, cache_time);
+  if (have_cache && (!have_text || (text_time <= cache_time))) {
+    if (this->ReadServiceTimesCache(cache_filename)) {
+      return;
+    }
+  }
+
+  actual_service_times_.clear();
   Scanner service_times_file;
-  service_times_file.OpenFile("dataallsorted.txt");
+  service_times_file.OpenFile(service_times_filename_);
   while (service_times_file.HasNext()) {
     int thetime = service_times_file.NextInt();
     actual_service_times_.push_back(thetime);
   }
+  service_times_file.Close();
+
+  this->WriteServiceTimesCache(cache_filename);
+}
+
+/****************************************************************
+* Function 'ReadServiceTimesCache'
+*
+* Maps the binary service times file and copies the times out if the
+* header, the size, and the checksum all agree.
+*
+* Parameters:
+*    cache_filename - the binary file
+*
+* Returns:
+*    true if the times were read
+**/
+bool Configuration::ReadServiceTimesCache(const string& cache_filename) {
+  MappedFile mapped;
+  if (!mapped.Open(cache_filename)) {
+    return false;
+  }
+  if (mapped.GetSize() < sizeof(ServiceCacheHeader)) {
+    return false;
+  }
+
+  const ServiceCacheHeader *header =
+      reinterpret_cast<const ServiceCacheHeader *>(mapped.GetData());
+  if ((0 != memcmp(header->magic, kServiceCacheMagic,
+                   sizeof(kServiceCacheMagic)))
+      || (kServiceCacheVersion != header->version)) {
+    return false;
+  }
+  size_t expected_size = sizeof(ServiceCacheHeader)
+                       + (static_cast<size_t>(header->count) + 1)
+                         * sizeof(int32_t);
+  if (mapped.GetSize() != expected_size) {
+    return false;
+  }
+
+  const int32_t *times = reinterpret_cast<const int32_t *>(
+      mapped.GetData() + sizeof(ServiceCacheHeader));
+  uint32_t checksum = static_cast<uint32_t>(times[header->count]);
+  if (ServiceCacheChecksum(times, header->count) != checksum) {
+    return false;
+  }
+
+  actual_service_times_.assign(times, times + header->count);
+  return true;
+}
+
+/****************************************************************
+* Function 'WriteServiceTimesCache'
+*
+* Writes the binary service times file.  Many runs may start at once,
+* so the file is written under a name of its own and renamed into
+* place, and a run never maps a half-written file.  Failing to write
+* the file is not an error; the next run simply parses the text again.
+*
+* Parameters:
+*    cache_filename - the binary file
+**/
+void Configuration::WriteServiceTimesCache(
+                                    const string& cache_filename) const {
+  ServiceCacheHeader header;
+  memcpy(header.magic, kServiceCacheMagic, sizeof(kServiceCacheMagic));
+  header.version = kServiceCacheVersion;
+  header.count = static_cast<uint32_t>(actual_service_times_.size());
+
+  vector<int32_t> times(actual_service_times_.begin(),
+                        actual_service_times_.end());
+  uint32_t checksum = ServiceCacheChecksum(times.data(), header.count);
+
+  string temp_filename = cache_filename + "."
+                       + Utils::Format(static_cast<int>(getpid())) + ".tmp";
+  ofstream cache_stream(temp_filename, ios::out | ios::binary);
+  if (!cache_stream) {
+    cout << kTag << "cannot write '" << cache_filename << "'" << endl;
+    return;
+  }
+  cache_stream.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  cache_stream.write(reinterpret_cast<const char *>(times.data()),
+                     times.size() * sizeof(int32_t));
+  cache_stream.write(reinterpret_cast<const char *>(&checksum),
+                     sizeof(checksum));
+  cache_stream.close();
+
+  if (!cache_stream || (0 != rename(temp_filename.c_str(),
+                                    cache_filename.c_str()))) {
+    cout << kTag << "cannot write '" << cache_filename << "'" << endl;
+    remove(temp_filename.c_str());
+  }
+}
+
+/****************************************************************
+* Function 'ReadOptions'
+*
+* Reads the optional '--name value' pairs that follow the required
+* file names on the command line.  An unknown option or a missing or
+* bad value prints a message and stops the program.
+*
+* Parameters:
+*    argc - the usual 'argc' of command line information
+*    argv - the usual 'argv' of command line information
+*    first_option - subscript in 'argv' of the first option
+**/
+void Configuration::ReadOptions(int argc, char *argv[], int first_option) {
+  for (int sub = first_option; sub < argc; sub += 2) {
+    string name = static_cast<string>(argv[sub]);
+    if (sub + 1 >= argc) {
+      cout << kTag << "option '" << name << "' needs a value" << endl;
+      exit(1);
+    }
+    string value = static_cast<string>(argv[sub + 1]);
+
+    if ("--engine" == name) {
+      if (("event" != value) && ("fifo" != value) && ("verify" != value) &&
+          ("fluid" != value)) {
+        cout << kTag << "engine must be 'event', 'fifo', 'verify', or "
+             << "'fluid'" << endl;
+        exit(1);
+      }
+      engine_ = value;
+    } else if ("--population" == name) {
+      if (("fresh" != value) && ("shared" != value)) {
+        cout << kTag << "population must be 'fresh' or 'shared'" << endl;
+        exit(1);
+      }
+      population_ = value;
+    } else if ("--search" == name) {
+      if (("linear" != value) && ("bisect" != value)) {
+        cout << kTag << "search must be 'linear' or 'bisect'" << endl;
+        exit(1);
+      }
+      search_ = value;
+    } else if ("--iterations" == name) {
+      if (("fixed" != value) && ("adaptive" != value)) {
+        cout << kTag << "iterations must be 'fixed' or 'adaptive'" << endl;
+        exit(1);
+      }
+      iterations_ = value;
+    } else if ("--ci-measure" == name) {
+      if (("toolong" != value) && ("wait" != value)) {
+        cout << kTag << "ci-measure must be 'toolong' or 'wait'" << endl;
+        exit(1);
+      }
+      ci_measure_ = value;
+    } else if ("--ci-half-width" == name) {
+      ci_half_width_ = atof(value.c_str());
+      if (ci_half_width_ <= 0.0) {
+        cout << kTag << "ci-half-width must be a positive number" << endl;
+        exit(1);
+      }
+    } else if ("--max-iterations" == name) {
+      max_iterations_ = atoi(value.c_str());
+      if (max_iterations_ <= 0) {
+        cout << kTag << "max-iterations must be a positive number" << endl;
+        exit(1);
+      }
+    } else if ("--percentiles" == name) {
+      if (("off" != value) && ("on" != value)) {
+        cout << kTag << "percentiles must be 'off' or 'on'" << endl;
+        exit(1);
+      }
+      percentiles_ = value;
+    } else if ("--sampling" == name) {
+      if (("plain" != value) && ("antithetic" != value) &&
+          ("stratified" != value)) {
+        cout << kTag << "sampling must be 'plain', 'antithetic', or "
+             << "'stratified'" << endl;
+        exit(1);
+      }
+      sampling_ = value;
+    } else if ("--sampling-baseline" == name) {
+      if (("off" != value) && ("on" != value)) {
+        cout << kTag << "sampling-baseline must be 'off' or 'on'" << endl;
+        exit(1);
+      }
+      sampling_baseline_ = value;
+    } else if ("--screen" == name) {
+      if (("off" != value) && ("on" != value)) {
+        cout << kTag << "screen must be 'off' or 'on'" << endl;
+        exit(1);
+      }
+      screen_ = value;
+    } else if ("--control-variate" == name) {
+      if (("off" != value) && ("on" != value)) {
+        cout << kTag << "control-variate must be 'off' or 'on'" << endl;
+        exit(1);
+      }
+      control_variate_ = value;
+    } else if ("--flush" == name) {
+      if (("size" != value) && ("precinct" != value) && ("exit" != value)) {
+        cout << kTag << "flush must be 'size', 'precinct', or 'exit'" << endl;
+        exit(1);
+      }
+      flush_policy_ = value;
+    } else if ("--flush-bytes" == name) {
+      flush_bytes_ = atoi(value.c_str());
+      if (flush_bytes_ <= 0) {
+        cout << kTag << "flush-bytes must be a positive number" << endl;
+        exit(1);
+      }
+    } else if ("--log-writer" == name) {
+      if (("sync" != value) && ("async" != value)) {
+        cout << kTag << "log-writer must be 'sync' or 'async'" << endl;
+        exit(1);
+      }
+      log_writer_ = value;
+    } else if ("--log-queue" == name) {
+      log_queue_records_ = atoi(value.c_str());
+      if (log_queue_records_ <= 0) {
+        cout << kTag << "log-queue must be a positive number" << endl;
+        exit(1);
+      }
+    } else if ("--log-when-full" == name) {
+      if (("block" != value) && ("drop" != value)) {
+        cout << kTag << "log-when-full must be 'block' or 'drop'" << endl;
+        exit(1);
+      }
+      log_when_full_ = value;
+    } else if ("--service-times" == name) {
+      service_times_filename_ = value;
+    } else if ("--threads" == name) {
+      thread_count_ = atoi(value.c_str());
+      if (thread_count_ <= 0) {
+        cout << kTag << "threads must be a positive number" << endl;
+        exit(1);
+      }
+    } else {
+      cout << kTag << "unknown option '" << name << "'" << endl;
+      exit(1);
+    }
+  }
+
+  // the baseline iterations need voters of their own
+  if (("on" == sampling_baseline_) && ("shared" == population_)) {
+    cout << kTag << "sampling-baseline needs 'fresh' populations" << endl;
+    exit(1);
+  }
 }
 
 /****************************************************************
@@ -124,8 +419,41 @@ string Configuration::ToString() {
   s += Utils::Format(wait_time_minutes_that_is_too_long_, 8) + "\n";
   s += "Number of iterations to perform: ";
   s += Utils::Format(number_of_iterations_, 4) + "\n";
+  s += "Service times file: " + service_times_filename_ + "\n";
   s += "Max service time subscript: ";
   s += Utils::Format(GetMaxServiceSubscript(), 6) + "\n";
+  s += service_table_.ToString();
+  s += "Queue engine: " + engine_ + "\n";
+  s += "Voter population per iteration: " + population_ + "\n";
+  s += "Station count search: " + search_ + "\n";
+  s += "Threads (0 runs precincts in the main thread): ";
+  s += Utils::Format(thread_count_, 4) + "\n";
+  s += "Iterations: " + iterations_;
+  if ("adaptive" == iterations_) {
+    s += ", " + ci_measure_ + " 95% half-width ";
+    s += Utils::Format(ci_half_width_, 8, 4) + ", at most ";
+    s += Utils::Format(max_iterations_, 6);
+  }
+  s += "\n";
+  s += "Sampling: " + sampling_;
+  if ("on" == sampling_baseline_) {
+    s += ", with plain baseline";
+  }
+  s += "\n";
+  s += "Station count screen: " + screen_ + "\n";
+  s += "Control variate: " + control_variate_ + "\n";
+  s += "Wait percentiles: " + percentiles_ + "\n";
+  s += "Output flush: " + flush_policy_;
+  if ("size" == flush_policy_) {
+    s += ", every " + Utils::Format(flush_bytes_) + " bytes";
+  }
+  s += "\n";
+  s += "Log writer: " + log_writer_;
+  if ("async" == log_writer_) {
+    s += ", queue " + Utils::Format(log_queue_records_) + " records, "
+       + log_when_full_ + " when full";
+  }
+  s += "\n";
   
   int offset = 6;
   s += kTag;
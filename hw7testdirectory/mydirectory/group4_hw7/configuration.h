@@ -18,14 +18,19 @@
 #ifndef CONFIGURATION_H
 #define CONFIGURATION_H
 
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
 #include <set>
 #include <vector>
 
 #include "../Utilities/utils.h"
+#include "../Utilities/mappedfile.h"
 #include "../Utilities/scanner.h"
 #include "../Utilities/scanline.h"
 
 #include "myrandom.h"
+#include "servicetable.h"
 
 using namespace std;
 
@@ -57,19 +62,92 @@ public:
  int wait_time_minutes_that_is_too_long_ = kDummyConfigInt;
  int number_of_iterations_ = kDummyConfigInt;
  vector<int> actual_service_times_;
+ ServiceTable service_table_;
  double arrival_zero_ = kDummyConfigDouble;
  vector<double> arrival_fractions_;
 
+/****************************************************************
+ * Run options, set from the command line rather than the file.
+ *
+ * engine_ - 'event' for the general event-driven queue,
+ *           'fifo' for the station free-time recursion,
+ *           'verify' to run both and check that they agree,
+ *           'fluid' for a quick deterministic fluid approximation in
+ *           place of the simulation
+ * population_ - 'fresh' to create new voters for every station count,
+ *               'shared' to run every station count against the same
+ *               voters in each iteration
+ * search_ - 'linear' to try station counts upward from the minimum,
+ *           'bisect' to bracket and bisect for the smallest adequate one
+ * thread_count_ - 0 to run the precincts one at a time in the main
+ *                 thread, or the number of threads to run them on
+ * iterations_ - 'fixed' to run 'number_of_iterations_' for every station
+ *               count, 'adaptive' to run at least that many and then
+ *               more until the 95% confidence interval on the mean of
+ *               'ci_measure_' has half-width at most 'ci_half_width_',
+ *               or 'max_iterations_' have been run
+ * ci_measure_ - 'toolong' for the fraction of voters who waited too
+ *               long, 'wait' for the mean wait in minutes
+ * sampling_ - 'plain' to draw every iteration independently,
+ *             'antithetic' to run the iterations in pairs whose random
+ *             numbers mirror each other, 'stratified' to draw each
+ *             hour's voting times one from each slice of probability
+ * sampling_baseline_ - 'on' to also run a plain iteration beside each
+ *                      iteration, only to measure how much 'sampling_'
+ *                      reduces the variance
+ * screen_ - 'on' to skip station counts that queueing approximations
+ *           show are certainly inadequate or certainly sufficient,
+ *           simulating only the counts in between
+ * control_variate_ - 'on' to adjust the mean wait for each station
+ *                    count with a control variate from an M/G/c
+ *                    approximation of each hour's wait
+ * percentiles_ - 'on' to report percentiles of the waits for each
+ *                station count, for the day and for each hour
+ * flush_policy_ - when output is written to the output and log files:
+ *                 'size' once 'flush_bytes_' have been written,
+ *                 'precinct' after each precinct, 'exit' at the end
+ * log_writer_ - 'async' to write the log file from a thread of its
+ *               own, 'sync' to write it from the thread producing it
+ * log_queue_records_ - the most records the 'async' log writer queues
+ * log_when_full_ - 'block' to wait when the log queue is full, 'drop'
+ *                  to drop the record and count it
+ * service_times_filename_ - the text file of measured voting times; a
+ *                           binary copy is kept beside it with '.bin'
+ *                           appended to the name
+**/
+ string engine_ = "event";
+ string population_ = "fresh";
+ string search_ = "linear";
+ int thread_count_ = 0;
+ string iterations_ = "fixed";
+ string ci_measure_ = "toolong";
+ double ci_half_width_ = 0.01;
+ int max_iterations_ = 100;
+ string sampling_ = "plain";
+ string sampling_baseline_ = "off";
+ string screen_ = "off";
+ string control_variate_ = "off";
+ string percentiles_ = "off";
+ string flush_policy_ = "precinct";
+ int flush_bytes_ = 1 << 20;
+ string log_writer_ = "async";
+ int log_queue_records_ = 1024;
+ string log_when_full_ = "block";
+ string service_times_filename_ = "dataallsorted.txt";
+
 /****************************************************************
  * General functions.
 **/
 
  int GetMaxServiceSubscript() const;
  void ReadConfiguration(Scanner& instream);
+ void ReadOptions(int argc, char *argv[], int first_option);
  string ToString();
 
 private:
-
+ bool ReadServiceTimesCache(const string& cache_filename);
+ void ReadServiceTimes();
+ void WriteServiceTimesCache(const string& cache_filename) const;
 };
 
 #endif // ONEVOTER_H
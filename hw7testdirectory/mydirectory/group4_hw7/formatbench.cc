@@ -0,0 +1,240 @@
+/****************************************************************
+ * Benchmark for the number formatting.
+ * Builds the line 'DoStatistics' writes for each iteration over and
+ * over, once as the formatting used to be done, through a shared
+ * 'ostringstream' and strings added together, and once by appending
+ * to a 'FormatBuffer', and reports the time per line for each.  It
+ * first checks over many values and widths that the two give exactly
+ * the same text, and stops if they do not.
+ *
+ * Usage: formatbench [lines]
+ *
+ * Author/copyright:  Duncan Buell. All rights reserved.
+ * Used with permission and modified by: Group 4
+ *                                       Erik Akeyson
+ *                                       Matthew Clapp
+ *                                       Harrison Goodman
+ *                                       Andy Michels
+ *                                       Steve Smero
+ * Date: 1 December 2016
+ *
+**/
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "../Utilities/utils.h"
+#include "../Utilities/formatbuffer.h"
+
+using namespace std;
+
+static const string kTag = "FORMATBENCH: ";
+
+// the formatting as it was before 'FormatBuffer', kept here to compare
+static ostringstream old_oss;
+
+static string OldFormat(const int value, const int width) {
+  old_oss.str("");
+  old_oss.setf(ios::right, ios::adjustfield);
+  old_oss << setw(width) << value;
+  return old_oss.str();
+}
+
+static string OldFormat(const string value, const int width,
+                        const string justify) {
+  old_oss.str("");
+  if ("left" == justify) {
+    old_oss.setf(ios::left, ios::adjustfield);
+  } else {
+    old_oss.setf(ios::right, ios::adjustfield);
+  }
+  old_oss << setw(width) << value;
+  return old_oss.str();
+}
+
+static string OldFormat(const double value, const int width,
+                        const int precision) {
+  old_oss.str("");
+  old_oss << fixed << setprecision(precision) << setw(width) << value;
+  return OldFormat(old_oss.str(), width, "right");
+}
+
+/****************************************************************
+ * The values for one line, varied from line to line.
+**/
+struct LineValues {
+  int iteration;
+  int pct_number;
+  string pct_name;
+  int expected;
+  int stations;
+  double mean;
+  double dev;
+  int too_long;
+};
+
+static LineValues MakeValues(uint64_t& state) {
+  // a small xorshift, so every run formats the same values
+  state ^= state << 13;
+  state ^= state >> 7;
+  state ^= state << 17;
+  LineValues values;
+  values.iteration = static_cast<int>(state % 1000);
+  values.pct_number = static_cast<int>((state >> 10) % 10000);
+  values.pct_name = (0 == state % 3) ? "WARD_1_PRECINCT_NUMBER_TWO"
+                                     : "COLUMBIA_12";
+  values.expected = 1 + static_cast<int>((state >> 20) % 5000);
+  values.stations = 1 + static_cast<int>((state >> 34) % 40);
+  values.mean = static_cast<double>(state % 1000003) / 977.0 - 3.0;
+  values.dev = static_cast<double>((state >> 24) % 100003) / 131.0;
+  values.too_long = static_cast<int>((state >> 40) % values.expected);
+  return values;
+}
+
+static string OldLine(const LineValues& v) {
+  return kTag + OldFormat(v.iteration, 3) + " "
+       + OldFormat(v.pct_number, 4) + " "
+       + OldFormat(v.pct_name, 25, "left")
+       + OldFormat(v.expected, 6)
+       + OldFormat(v.stations, 4)
+       + " stations, mean/dev wait (mins) "
+       + OldFormat(v.mean, 8, 2) + " "
+       + OldFormat(v.dev, 8, 2)
+       + " toolong "
+       + OldFormat(v.too_long, 6) + " "
+       + OldFormat(100.0 * v.too_long / v.expected, 6, 2)
+       + OldFormat(v.too_long / 2, 6) + " "
+       + OldFormat(50.0 * v.too_long / v.expected, 6, 2)
+       + OldFormat(v.too_long / 4, 6) + " "
+       + OldFormat(25.0 * v.too_long / v.expected, 6, 2)
+       + "\n";
+}
+
+static void NewLine(const LineValues& v, FormatBuffer& line) {
+  line.Clear();
+  line.Append(kTag).Append(v.iteration, 3).Append(" ")
+      .Append(v.pct_number, 4).Append(" ")
+      .Append(v.pct_name, 25, "left")
+      .Append(v.expected, 6)
+      .Append(v.stations, 4)
+      .Append(" stations, mean/dev wait (mins) ")
+      .Append(v.mean, 8, 2).Append(" ")
+      .Append(v.dev, 8, 2)
+      .Append(" toolong ")
+      .Append(v.too_long, 6).Append(" ")
+      .Append(100.0 * v.too_long / v.expected, 6, 2)
+      .Append(v.too_long / 2, 6).Append(" ")
+      .Append(50.0 * v.too_long / v.expected, 6, 2)
+      .Append(v.too_long / 4, 6).Append(" ")
+      .Append(25.0 * v.too_long / v.expected, 6, 2)
+      .Append("\n");
+}
+
+/****************************************************************
+ * Checks that 'Utils::Format' and 'FormatBuffer' give what the
+ * stream gave, for integers, fixed doubles, and strings.
+ *
+ * Returns:
+ *   the number of mismatches, each of which is printed
+**/
+static int CheckSameText() {
+  int mismatches = 0;
+  uint64_t state = 88172645463325252ULL;
+  for (int sub = 0; sub < 200000; ++sub) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    int width = static_cast<int>(state % 12);
+    int precision = static_cast<int>((state >> 8) % 6);
+    int whole = static_cast<int>(state >> 32) >> (state % 31);
+    double fraction = static_cast<double>(static_cast<int64_t>(state))
+                    / pow(10.0, static_cast<double>((state >> 16) % 22));
+
+    string before = OldFormat(whole, width);
+    string after = Utils::Format(whole, width);
+    if (before != after) {
+      cout << kTag << "int '" << before << "' '" << after << "'" << endl;
+      ++mismatches;
+    }
+
+    before = OldFormat(fraction, width, precision);
+    FormatBuffer line;
+    line.Append(fraction, width, precision);
+    if ((before != line.GetString())
+     || (before != Utils::Format(fraction, width, precision))) {
+      cout << kTag << "double '" << before << "' '" << line.GetString()
+           << "'" << endl;
+      ++mismatches;
+    }
+
+    string text = string(static_cast<size_t>(state % 9), 'x');
+    string justify = (0 == (state >> 5) % 2) ? "left" : "right";
+    before = OldFormat(text, width, justify);
+    if (before != Utils::Format(text, width, justify)) {
+      cout << kTag << "string '" << before << "'" << endl;
+      ++mismatches;
+    }
+  }
+  return mismatches;
+}
+
+int main(int argc, char *argv[]) {
+  int lines = 1000000;
+  if (argc > 1) {
+    lines = atoi(argv[1]);
+  }
+
+  int mismatches = CheckSameText();
+  if (mismatches > 0) {
+    cout << kTag << mismatches << " MISMATCHES" << endl;
+    return 1;
+  }
+  cout << kTag << "formatted text matches the stream's" << endl;
+
+  uint64_t state = 2463534242ULL;
+  LineValues values = MakeValues(state);
+  FormatBuffer line;
+  NewLine(values, line);
+  if (OldLine(values) != line.GetString()) {
+    cout << kTag << "LINE MISMATCH" << endl;
+    return 1;
+  }
+
+  // the byte counts keep the compiler from dropping the work
+  LONG old_bytes = 0;
+  state = 2463534242ULL;
+  chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+  for (int sub = 0; sub < lines; ++sub) {
+    values = MakeValues(state);
+    old_bytes += static_cast<LONG>(OldLine(values).size());
+  }
+  chrono::duration<double> old_time = chrono::steady_clock::now() - begin;
+
+  LONG new_bytes = 0;
+  state = 2463534242ULL;
+  begin = chrono::steady_clock::now();
+  for (int sub = 0; sub < lines; ++sub) {
+    values = MakeValues(state);
+    NewLine(values, line);
+    new_bytes += static_cast<LONG>(line.GetSize());
+  }
+  chrono::duration<double> new_time = chrono::steady_clock::now() - begin;
+
+  double old_ns = 1.0e9 * old_time.count() / lines;
+  double new_ns = 1.0e9 * new_time.count() / lines;
+  cout << kTag << "lines " << Utils::Format(lines, 10)
+       << " bytes " << Utils::Format(old_bytes, 12)
+       << Utils::Format(new_bytes, 12) << endl;
+  cout << kTag << "stream and strings " << Utils::Format(old_ns, 10, 1)
+       << " ns/line" << endl;
+  cout << kTag << "format buffer      " << Utils::Format(new_ns, 10, 1)
+       << " ns/line" << endl;
+  cout << kTag << "speedup            "
+       << Utils::Format(old_ns / new_ns, 10, 2) << endl;
+
+  return 0;
+}
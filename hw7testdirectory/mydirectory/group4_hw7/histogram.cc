@@ -0,0 +1,187 @@
+#include "histogram.h"
+/****************************************************************
+ * Implementation for the 'Histogram' class.
+ * A histogram is a plain array of counts, one per value, so counting
+ * a value is one increment and merging two histograms is one pass of
+ * additions over the arrays, which the compiler vectorizes.  Values
+ * too big for the array are only counted, in an overflow bin, so the
+ * array never grows once it has been sized.
+ *
+ * Histograms kept separately, say by different threads, are combined
+ * with 'Merge'.
+ *
+ * Author/copyright:  Duncan Buell. All rights reserved.
+ * Used with permission and modified by: Group 4
+ *                                       Erik Akeyson
+ *                                       Matthew Clapp
+ *                                       Harrison Goodman
+ *                                       Andy Michels
+ *                                       Steve Smero
+ * Date: 1 December 2016
+**/
+
+static const string kTag = "HISTOGRAM: ";
+
+/****************************************************************
+* Constructor.
+**/
+Histogram::Histogram() {
+}
+
+/****************************************************************
+* Constructor.
+*
+* Parameters:
+*    bin_count - values 0 through 'bin_count' - 1 have bins of their own
+**/
+Histogram::Histogram(int bin_count) {
+  this->SetBinCount(bin_count);
+}
+
+/****************************************************************
+* Destructor.
+**/
+Histogram::~Histogram() {
+}
+
+/****************************************************************
+* Accessors and mutators.
+**/
+/****************************************************************
+**/
+int Histogram::GetBinCount() const {
+  return bin_count_;
+}
+
+/****************************************************************
+* Returns:
+*    the count for 'value', or 0 if it has no bin of its own
+**/
+int Histogram::GetCount(int value) const {
+  if ((value < 0) || (value > max_value_)) {
+    return 0;
+  }
+  return counts_[value];
+}
+
+/****************************************************************
+* Returns:
+*    the largest value counted in a bin, or -1 if there is none
+**/
+int Histogram::GetMaxValue() const {
+  return max_value_;
+}
+
+/****************************************************************
+* Returns:
+*    the smallest value counted in a bin, or -1 if there is none
+**/
+int Histogram::GetMinValue() const {
+  for (int value = 0; value <= max_value_; ++value) {
+    if (counts_[value] > 0) {
+      return value;
+    }
+  }
+  return -1;
+}
+
+/****************************************************************
+**/
+int Histogram::GetOverflowCount() const {
+  return overflow_count_;
+}
+
+/****************************************************************
+* Returns:
+*    the number of values counted, including the overflow
+**/
+LONG Histogram::GetTotalCount() const {
+  LONG total = overflow_count_;
+  for (int value = 0; value <= max_value_; ++value) {
+    total += counts_[value];
+  }
+  return total;
+}
+
+/****************************************************************
+* Sizes the histogram and empties it.
+*
+* Parameters:
+*    bin_count - values 0 through 'bin_count' - 1 have bins of their own
+**/
+void Histogram::SetBinCount(int bin_count) {
+  bin_count_ = bin_count;
+  counts_.assign(bin_count, 0);
+  overflow_count_ = 0;
+  max_value_ = -1;
+}
+
+/****************************************************************
+* General functions.
+**/
+/****************************************************************
+* Function 'Clear'
+*
+* Empties the histogram, touching only the bins that may be in use.
+**/
+void Histogram::Clear() {
+  for (int value = 0; value <= max_value_; ++value) {
+    counts_[value] = 0;
+  }
+  overflow_count_ = 0;
+  max_value_ = -1;
+}
+
+/****************************************************************
+* Function 'Merge'
+*
+* Adds the counts of another histogram to this one.  Bins of the
+* other histogram past the end of this one go to the overflow bin.
+* A histogram that was never sized takes the size of the other, so a
+* total can start out as an empty 'Histogram()'.
+*
+* Parameters:
+*    that - the histogram to add in
+**/
+void Histogram::Merge(const Histogram& that) {
+  if (0 == bin_count_) {
+    this->SetBinCount(that.bin_count_);
+  }
+
+  int common = that.max_value_ + 1;
+  if (common > bin_count_) {
+    common = bin_count_;
+  }
+
+  int *mine = counts_.data();
+  const int *theirs = that.counts_.data();
+  for (int value = 0; value < common; ++value) {
+    mine[value] += theirs[value];
+  }
+  for (int value = common; value <= that.max_value_; ++value) {
+    overflow_count_ += theirs[value];
+  }
+  overflow_count_ += that.overflow_count_;
+
+  // the last bin added to may be empty if the other's were cut short
+  for (int value = common - 1; value > max_value_; --value) {
+    if (mine[value] > 0) {
+      max_value_ = value;
+      break;
+    }
+  }
+}
+
+/****************************************************************
+* Usual 'ToString'.
+**/
+string Histogram::ToString() const {
+  string s = "";
+
+  s += kTag + "bins " + Utils::Format(bin_count_, 6)
+     + " values " + Utils::Format(this->GetMinValue(), 6)
+     + " to " + Utils::Format(max_value_, 6)
+     + " overflow " + Utils::Format(overflow_count_, 8) + "\n";
+
+  return s;
+}
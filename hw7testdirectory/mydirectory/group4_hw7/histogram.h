@@ -0,0 +1,80 @@
+/****************************************************************
+ * Header for the 'Histogram' class.
+ * Counts of small non-negative integers, such as wait times in whole
+ * minutes, in a fixed array of bins with one more bin for anything
+ * too big to fit.
+ *
+ * Author/copyright:  Duncan Buell
+ * Used with permission and modified by: Group 4
+ *                                       Erik Akeyson
+ *                                       Matthew Clapp
+ *                                       Harrison Goodman
+ *                                       Andy Michels
+ *                                       Steve Smero
+ * Date: 1 December 2016
+ *
+**/
+
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <vector>
+
+#include "../Utilities/utils.h"
+
+using namespace std;
+
+class Histogram {
+public:
+/****************************************************************
+ * Constructors and destructors for the class.
+**/
+ Histogram();
+ Histogram(int bin_count);
+ virtual ~Histogram();
+
+/****************************************************************
+ * Accessors and Mutators.
+**/
+ int GetBinCount() const;
+ int GetCount(int value) const;
+ int GetMaxValue() const;
+ int GetMinValue() const;
+ int GetOverflowCount() const;
+ LONG GetTotalCount() const;
+ void SetBinCount(int bin_count);
+
+/****************************************************************
+ * General functions.
+**/
+ void Clear();
+ void Merge(const Histogram& that);
+
+/****************************************************************
+ * Counts one value.  This is called once for every voter, so it is
+ * here in the header where it can be inlined.  Values past the last
+ * bin go to the overflow bin; there are no negative values.
+**/
+ void Add(int value) {
+   if (value < bin_count_) {
+     ++counts_[value];
+     if (value > max_value_) {
+       max_value_ = value;
+     }
+   } else {
+     ++overflow_count_;
+   }
+ }
+
+ string ToString() const;
+
+private:
+ int bin_count_ = 0;
+ vector<int> counts_;
+ int overflow_count_ = 0;
+
+ // all bins past this one are zero
+ int max_value_ = -1;
+};
+
+#endif // HISTOGRAM_H
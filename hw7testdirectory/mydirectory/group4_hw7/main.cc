@@ -42,59 +42,130 @@ int main(int argc, char *argv[]) {
 
   cout<< kTag << "Beginning execution" << endl;
 
-  Utils::CheckArgs(4, argc, argv, "configfilename pctfilename outfilename logfilename");
+  Utils::CheckArgsAtLeast(4, argc, argv,
+                          "configfilename pctfilename outfilename logfilename "
+                          "[--engine event|fifo|verify|fluid] "
+                          "[--population fresh|shared] "
+                          "[--search linear|bisect] "
+                          "[--screen off|on] "
+                          "[--threads N] "
+                          "[--iterations fixed|adaptive] "
+                          "[--ci-measure toolong|wait] "
+                          "[--ci-half-width W] "
+                          "[--max-iterations N] "
+                          "[--percentiles off|on] "
+                          "[--sampling plain|antithetic|stratified] "
+                          "[--sampling-baseline off|on] "
+                          "[--control-variate off|on] "
+                          "[--flush size|precinct|exit] "
+                          "[--flush-bytes N] "
+                          "[--log-writer sync|async] "
+                          "[--log-queue N] "
+                          "[--log-when-full block|drop] "
+                          "[--service-times FILE]");
   config_filename = static_cast<string>(argv[1]);
   pct_filename = static_cast<string>(argv[2]);
   out_filename = static_cast<string>(argv[3]);
   log_filename = static_cast<string>(argv[4]);
 
+  ////////////////////////////////////////////////////////////////////
+  // config has RN seed, station count spread, election day length
+  //   and mean and dev voting time
+  //   (the options come first since they can name the data files,
+  //   and both are read before the output and log files are opened,
+  //   so that a mistake in either leaves the last run's files alone)
+  config.ReadOptions(argc, argv, 5);
+  config_stream.OpenFile(config_filename);
+  config.ReadConfiguration(config_stream);
+  config_stream.Close();
+
   Utils::FileOpen(out_stream, out_filename);
   Utils::LogFileOpen(log_filename);
 
+  // everything for the output and log files goes through one buffer,
+  // written out as the flush option says
+  BufferedOutput output(out_stream, Utils::log_stream);
+
   outstring = kTag + "Beginning execution\n";
   outstring += kTag + Utils::TimeCall("beginning");
-  out_stream << outstring << endl;
-  Utils::log_stream << outstring << endl;
+  output.Write(outstring + "\n");
 
   outstring = kTag + "outfile '" + out_filename + "'" + "\n";
   outstring += kTag + "logfile '" + log_filename + "'" + "\n";
-  out_stream << outstring << endl;
-  Utils::log_stream << outstring << endl;
+  output.Write(outstring + "\n");
 
-  ////////////////////////////////////////////////////////////////////
-  // config has RN seed, station count spread, election day length
-  //   and mean and dev voting time
-  config_stream.OpenFile(config_filename);
-  config.ReadConfiguration(config_stream);
-  config_stream.Close();
+  output.SetPolicy(config.flush_policy_, config.flush_bytes_);
 
   outstring = kTag + config.ToString() + "\n";
-  out_stream << outstring << endl;
-  Utils::log_stream << outstring << endl;
+  output.Write(outstring + "\n");
 
   random = MyRandom(config.seed_);
 
   ////////////////////////////////////////////////////////////////////
-  // now read the precinct data
-  pct_stream.OpenFile(pct_filename);
-  simulation.ReadPrecincts(pct_stream);
-  pct_stream.Close();
+  // now read the precinct data, as text or as a binary table made
+  //   from the text by 'pctconvert'
+  if (PctTable::IsTableFile(pct_filename)) {
+    PctTable pct_table;
+    pct_table.Map(pct_filename);
+    simulation.ReadPrecincts(pct_table);
+  } else {
+    pct_stream.OpenFile(pct_filename);
+    simulation.ReadPrecincts(pct_stream);
+    pct_stream.Close();
+  }
+
+  ////////////////////////////////////////////////////////////////////
+  // from here until the shutdown below the log file is written only
+  // by the log writer's thread, so nothing else may write to it
+  AsyncLogWriter log_writer(Utils::log_stream, config.log_queue_records_,
+                            config.log_when_full_);
+  if ("async" == config.log_writer_) {
+    output.SetLogWriter(&log_writer);
+    log_writer.Start();
+  }
 
   ////////////////////////////////////////////////////////////////////
-  // here is the real work
-  simulation.RunSimulation(config, random, out_stream);
+  // here is the real work, or a quick approximate look at it; the
+  // files are closed up as usual even if the engines disagreed,
+  // and then we stop
+  bool engines_agree = true;
+  if ("fluid" == config.engine_) {
+    simulation.RunApproximation(config, output);
+  } else {
+    engines_agree = simulation.RunSimulation(config, random, output);
+  }
 
   ////////////////////////////////////////////////////////////////////
   // close up and go home
   outstring = kTag + "Ending execution" + "\n";
   outstring += kTag + Utils::TimeCall("ending");
-  out_stream << outstring << endl;
-  Utils::log_stream << outstring << endl;
+  output.Write(outstring + "\n");
+  output.Flush();
+
+  // in order: the buffer is flushed into the queue above, the queue is
+  // written out and the thread stopped, and only then is the log file
+  // ours again to write the counts and close
+  if ("async" == config.log_writer_) {
+    log_writer.Shutdown();
+    output.SetLogWriter(nullptr);
+  }
+
+  outstring = kTag + "output flushes " + Utils::Format(output.GetFlushCount())
+            + " bytes " + Utils::Format(output.GetBytesWritten()) + "\n";
+  if ("async" == config.log_writer_) {
+    outstring += kTag + log_writer.ToString();
+  }
+  cout << outstring;
+  Utils::log_stream << outstring;
 
   Utils::FileClose(out_stream);
   Utils::FileClose(Utils::log_stream);
 
   cout << kTag << "Ending execution" << endl;
 
+  if (!engines_agree) {
+    exit(1);
+  }
+
   return 0;
 }
@@ -19,6 +19,7 @@
 #define MAIN_H
 
 #include "../Utilities/utils.h"
+#include "../Utilities/bufferedoutput.h"
 #include "../Utilities/scanner.h"
 #include "../Utilities/scanline.h"
 
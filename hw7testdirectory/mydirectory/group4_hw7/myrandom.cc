@@ -24,7 +24,7 @@
 **/
 MyRandom::MyRandom() {
   seed_ = 1;
-  generator_.seed(seed_);
+  generator_.SetKey(seed_, 0);
 }
 
 /******************************************************************************
@@ -32,7 +32,16 @@ MyRandom::MyRandom() {
 **/
 MyRandom::MyRandom(unsigned seed) {
   seed_ = seed;
-  generator_.seed(seed_);
+  generator_.SetKey(seed_, 0);
+}
+
+/******************************************************************************
+ * Constructor for the stream of one precinct.  This is the same as
+ * calling 'SelectStream(stream, 0, 0)' on a generator with this seed.
+**/
+MyRandom::MyRandom(unsigned seed, unsigned stream) {
+  seed_ = seed;
+  generator_.SetKey(seed_, stream);
 }
 
 /******************************************************************************
@@ -48,6 +57,255 @@ MyRandom::~MyRandom() {
 /******************************************************************************
  * General functions.
 **/
+/******************************************************************************
+ * Function 'SelectStream'.
+ * Moves to the start of the stream for one piece of work.  The seed and
+ * the precinct number make up the key and the station count and the
+ * iteration make up the counter, so the numbers drawn for any
+ * (seed, precinct, stations, iteration) are always the same, whatever
+ * has been simulated before and on whatever thread.
+ *
+ * Parameters:
+ *   pct_number - the precinct being simulated
+ *   station_count - the number of stations, or 0 for numbers shared by
+ *                   all station counts
+ *   iteration - the iteration number
+**/
+void MyRandom::SelectStream(unsigned pct_number, unsigned station_count,
+                            unsigned iteration) {
+  generator_.SetKey(seed_, pct_number);
+  generator_.SetCounter(iteration, station_count, 0);
+  generator_.SetComplement(false);
+}
+
+/******************************************************************************
+ * Function 'SelectAntitheticStream'.
+ * Moves to the start of the same stream as 'SelectStream', but with
+ * every number complemented, so that each uniform 'u' drawn from the
+ * stream becomes '1 - u'.  A draw made by inverting a distribution
+ * function from one uniform, such as 'FillExponentialInt', then gives
+ * the opposite end of the distribution from the plain stream.
+ *
+ * Parameters:
+ *   pct_number - the precinct being simulated
+ *   station_count - the number of stations, or 0 for numbers shared by
+ *                   all station counts
+ *   iteration - the iteration number of the plain stream to mirror
+**/
+void MyRandom::SelectAntitheticStream(unsigned pct_number,
+                                      unsigned station_count,
+                                      unsigned iteration) {
+  this->SelectStream(pct_number, station_count, iteration);
+  generator_.SetComplement(true);
+}
+
+/******************************************************************************
+ * Function 'FillBits'.
+ * Fills 'out' with the next 'count' raw 32-bit numbers of the stream,
+ * for callers such as 'ServiceTable' that map the bits themselves.
+ *
+ * Parameters:
+ *   count - how many to generate
+ *   out - where to put them
+**/
+void MyRandom::FillBits(int count, uint32_t *out) {
+  generator_.Fill(count, out);
+}
+
+/******************************************************************************
+ * Function 'FillExponentialInt'.
+ * Fills 'out' with 'count' exponentially distributed numbers with
+ * parameter 'lambda', each rounded to an 'int', as 'RandomExponentialInt'
+ * does one at a time.  The numbers are made by inversion from one
+ * 32-bit uniform each, offset by half a step so the log is never of zero.
+ *
+ * Parameters:
+ *   lambda - the lambda of the exponentially distributed RNs
+ *   count - how many to generate
+ *   out - where to put them
+**/
+void MyRandom::FillExponentialInt(double lambda, int count, int *out) {
+  assert(lambda >= 0.0);
+  const double kTwoToMinus32 = 1.0 / 4294967296.0;
+  if (static_cast<int>(bits_.size()) < count) {
+    bits_.resize(count);
+  }
+  generator_.Fill(count, bits_.data());
+
+  double mean = 1.0 / lambda;
+  for (int sub = 0; sub < count; ++sub) {
+    double uniform = (static_cast<double>(bits_[sub]) + 0.5) * kTwoToMinus32;
+    out[sub] = static_cast<int>(round(-log(uniform) * mean));
+  }
+}
+
+/******************************************************************************
+ * Function 'FillUniformInt'.
+ * Fills 'out' with 'count' 'int' random numbers uniformly distributed
+ * from 'lower' to 'upper' inclusive.  This uses Lemire's multiply and
+ * shift in place of a division, rejecting the rare draw that would
+ * bias the result and replacing it with the next number in the stream.
+ *
+ * Parameters:
+ *   lower - the smallest value of the RNs
+ *   upper - the largest value of the RNs
+ *   count - how many to generate
+ *   out - where to put them
+**/
+void MyRandom::FillUniformInt(int lower, int upper, int count, int *out) {
+  assert(lower <= upper);
+  uint32_t range = static_cast<uint32_t>(upper - lower) + 1u;
+  uint32_t threshold = (0u - range) % range;
+  if (static_cast<int>(bits_.size()) < count) {
+    bits_.resize(count);
+  }
+  generator_.Fill(count, bits_.data());
+
+  for (int sub = 0; sub < count; ++sub) {
+    uint64_t product = static_cast<uint64_t>(bits_[sub]) * range;
+    while (static_cast<uint32_t>(product) < threshold) {
+      product = static_cast<uint64_t>(generator_()) * range;
+    }
+    out[sub] = lower + static_cast<int>(product >> 32);
+  }
+}
+
+/******************************************************************************
+ * Function 'Philox::Fill'.
+ * Puts the next 'count' numbers of the stream into 'out', exactly as
+ * 'count' calls of the call operator would.  Whole blocks are done
+ * eight counters at a time with each round written as a loop across
+ * the eight, which the compiler turns into SIMD multiplies on any x86-64
+ * (SSE2 'pmuludq') and wider ones where the target allows.  The
+ * results are the same whether or not the loop is vectorized.
+ *
+ * Parameters:
+ *   count - how many numbers to generate
+ *   out - where to put them
+**/
+void MyRandom::Philox::Fill(int count, uint32_t *out) {
+  const int kLanes = 8;
+  const uint32_t kMultiplier0 = 0xD2511F53u;
+  const uint32_t kMultiplier1 = 0xCD9E8D57u;
+  const uint32_t kWeyl0 = 0x9E3779B9u;
+  const uint32_t kWeyl1 = 0xBB67AE85u;
+
+  int done = 0;
+  while ((done < count) && (used_ < 4)) {
+    out[done++] = block_[used_++];
+  }
+
+  while (count - done >= 4 * kLanes) {
+    uint32_t c0[kLanes], c1[kLanes], c2[kLanes], c3[kLanes];
+    for (int lane = 0; lane < kLanes; ++lane) {
+      c0[lane] = counter_[0] + lane;
+      c1[lane] = counter_[1];
+      c2[lane] = counter_[2];
+      c3[lane] = counter_[3];
+    }
+    uint32_t k0 = key_[0];
+    uint32_t k1 = key_[1];
+    for (int round = 0; round < 10; ++round) {
+      // kept as a loop, not unrolled, so that it is vectorized
+#pragma GCC unroll 1
+      for (int lane = 0; lane < kLanes; ++lane) {
+        uint64_t product0 = static_cast<uint64_t>(kMultiplier0) * c0[lane];
+        uint64_t product1 = static_cast<uint64_t>(kMultiplier1) * c2[lane];
+        uint32_t next0 = static_cast<uint32_t>(product1 >> 32) ^ c1[lane] ^ k0;
+        uint32_t next2 = static_cast<uint32_t>(product0 >> 32) ^ c3[lane] ^ k1;
+        c1[lane] = static_cast<uint32_t>(product1);
+        c3[lane] = static_cast<uint32_t>(product0);
+        c0[lane] = next0;
+        c2[lane] = next2;
+      }
+      k0 += kWeyl0;
+      k1 += kWeyl1;
+    }
+    for (int lane = 0; lane < kLanes; ++lane) {
+      out[done + 4 * lane] = c0[lane] ^ complement_;
+      out[done + 4 * lane + 1] = c1[lane] ^ complement_;
+      out[done + 4 * lane + 2] = c2[lane] ^ complement_;
+      out[done + 4 * lane + 3] = c3[lane] ^ complement_;
+    }
+    counter_[0] += kLanes;
+    done += 4 * kLanes;
+  }
+
+  while (done < count) {
+    out[done++] = (*this)();
+  }
+}
+
+/******************************************************************************
+ * Function 'Philox::SetKey'.
+ * Sets the key and starts again from block zero of stream (0, 0, 0).
+**/
+void MyRandom::Philox::SetKey(uint32_t key0, uint32_t key1) {
+  key_[0] = key0;
+  key_[1] = key1;
+  this->SetCounter(0, 0, 0);
+}
+
+/******************************************************************************
+ * Function 'Philox::SetComplement'.
+ * Sets whether each number is complemented, all 32 bits flipped, as it
+ * is handed out.  The block already computed is not changed.
+**/
+void MyRandom::Philox::SetComplement(bool complement) {
+  complement_ = complement ? 0xFFFFFFFFu : 0u;
+}
+
+/******************************************************************************
+ * Function 'Philox::SetCounter'.
+ * Sets the high three words of the counter and starts again from block
+ * zero.  The low word counts blocks within the stream, which allows
+ * 2^34 numbers per stream.
+**/
+void MyRandom::Philox::SetCounter(uint32_t counter1, uint32_t counter2,
+                                  uint32_t counter3) {
+  counter_[0] = 0;
+  counter_[1] = counter1;
+  counter_[2] = counter2;
+  counter_[3] = counter3;
+  used_ = 4;
+}
+
+/******************************************************************************
+ * Function 'Philox::NextBlock'.
+ * Computes the four outputs for the current counter with ten Philox
+ * rounds and then steps the counter.
+**/
+void MyRandom::Philox::NextBlock() {
+  const uint32_t kMultiplier0 = 0xD2511F53u;
+  const uint32_t kMultiplier1 = 0xCD9E8D57u;
+  const uint32_t kWeyl0 = 0x9E3779B9u;
+  const uint32_t kWeyl1 = 0xBB67AE85u;
+
+  uint32_t c0 = counter_[0];
+  uint32_t c1 = counter_[1];
+  uint32_t c2 = counter_[2];
+  uint32_t c3 = counter_[3];
+  uint32_t k0 = key_[0];
+  uint32_t k1 = key_[1];
+  for (int round = 0; round < 10; ++round) {
+    uint64_t product0 = static_cast<uint64_t>(kMultiplier0) * c0;
+    uint64_t product1 = static_cast<uint64_t>(kMultiplier1) * c2;
+    c0 = static_cast<uint32_t>(product1 >> 32) ^ c1 ^ k0;
+    c1 = static_cast<uint32_t>(product1);
+    c2 = static_cast<uint32_t>(product0 >> 32) ^ c3 ^ k1;
+    c3 = static_cast<uint32_t>(product0);
+    k0 += kWeyl0;
+    k1 += kWeyl1;
+  }
+  block_[0] = c0 ^ complement_;
+  block_[1] = c1 ^ complement_;
+  block_[2] = c2 ^ complement_;
+  block_[3] = c3 ^ complement_;
+  used_ = 0;
+
+  ++counter_[0];
+}
+
 
 /******************************************************************************
  * Function 'RandomExponentialInt'.
@@ -125,3 +383,17 @@ int MyRandom::RandomUniformInt(int lower, int upper) {
   int r = distribution(generator_);
   return r;
 }
+
+/******************************************************************************
+ * Function 'Reserve'.
+ * Makes room for batches of up to 'count' numbers, so that filling
+ * them later allocates nothing.
+ *
+ * Parameters:
+ *   count - the largest batch that will be asked for
+**/
+void MyRandom::Reserve(int count) {
+  if (static_cast<int>(bits_.size()) < count) {
+    bits_.resize(count);
+  }
+}
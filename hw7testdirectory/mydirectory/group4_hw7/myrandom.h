@@ -18,8 +18,11 @@
 #ifndef MYRANDOM_H
 #define MYRANDOM_H
 
+#include <cmath>
+#include <cstdint>
 #include <iostream>
 #include <random>
+#include <vector>
 #include <cassert>
 using namespace std;
 
@@ -32,17 +35,64 @@ class MyRandom {
 public:
  MyRandom();
  MyRandom(unsigned seed);
+ MyRandom(unsigned seed, unsigned stream);
  virtual ~MyRandom();
 
+ void SelectStream(unsigned pct_number, unsigned station_count,
+                   unsigned iteration);
+ void SelectAntitheticStream(unsigned pct_number, unsigned station_count,
+                             unsigned iteration);
+
  int RandomExponentialInt(double mean);
  double RandomNormal(double mean, double dev);
  double RandomUniformDouble(double lower, double upper);
  int RandomUniformInt(int lower, int upper);
 
+ void FillBits(int count, uint32_t *out);
+ void FillExponentialInt(double lambda, int count, int *out);
+ void FillUniformInt(int lower, int upper, int count, int *out);
+ void Reserve(int count);
+
 private:
+/****************************************************************
+ * Counter-based Philox4x32-10 generator (Salmon et al., SC 2011).
+ * Each output block is a fixed function of a 2-word key and a
+ * 4-word counter, so any stream can be started anywhere without
+ * generating what comes before it.  The call operator is here in the
+ * header so the distributions can inline it.
+**/
+ class Philox {
+ public:
+   typedef uint32_t result_type;
+   static constexpr result_type min() { return 0; }
+   static constexpr result_type max() { return 0xFFFFFFFFu; }
+
+   void Fill(int count, uint32_t *out);
+   void SetComplement(bool complement);
+   void SetKey(uint32_t key0, uint32_t key1);
+   void SetCounter(uint32_t counter1, uint32_t counter2, uint32_t counter3);
+
+   result_type operator()() {
+     if (used_ >= 4) {
+       this->NextBlock();
+     }
+     return block_[used_++];
+   }
+
+ private:
+   uint32_t key_[2] = {0, 0};
+   uint32_t counter_[4] = {0, 0, 0, 0};
+   uint32_t block_[4] = {0, 0, 0, 0};
+   uint32_t complement_ = 0;
+   int used_ = 4;
+
+   void NextBlock();
+ };
+
  unsigned int seed_;
 
- std::mt19937 generator_;
+ Philox generator_;
+ vector<uint32_t> bits_;
 };
 
 #endif
@@ -30,6 +30,95 @@
 
 static const string kTag = "OnePct: ";
 
+// 64-bit FNV-1a, for the checksum of the voters' starts and stations
+static const uint64_t kChecksumBasis = 14695981039346656037ULL;
+static const uint64_t kChecksumPrime = 1099511628211ULL;
+
+/****************************************************************
+* Function 'DrawServiceTimes'
+*
+* Draws 'count' service times from the table the way 'sampling' asks.
+*
+* Parameters:
+*    table - the table of measured times
+*    sampling - 'plain', 'antithetic', or 'stratified'
+*    random - the random stream to draw from
+*    count - how many times to draw
+*    out - where to put them
+**/
+static void DrawServiceTimes(const ServiceTable& table,
+                             const string& sampling, MyRandom& random,
+                             int count, int *out) {
+  if ("antithetic" == sampling) {
+    table.DrawAntithetic(random, count, out);
+  } else if ("stratified" == sampling) {
+    table.DrawStratified(random, count, out);
+  } else {
+    table.Draw(random, count, out);
+  }
+}
+
+/****************************************************************
+* Function 'ErlangC'
+*
+* The Erlang C probability that an arrival at 'stations' stations
+* must wait, from the Erlang B recursion.
+*
+* Parameters:
+*    stations - the number of stations
+*    offered - the offered load, arrival rate times mean service time,
+*              less than 'stations'
+*
+* Returns:
+*    the probability of waiting
+**/
+static double ErlangC(int stations, double offered) {
+  double erlang_b = 1.0;
+  for (int station = 1; station <= stations; ++station) {
+    erlang_b = offered * erlang_b / (station + offered * erlang_b);
+  }
+  double utilization = offered / static_cast<double>(stations);
+  return erlang_b / (1.0 - utilization * (1.0 - erlang_b));
+}
+
+/****************************************************************
+* Function 'ApproximateHourWait'
+*
+* Approximate mean wait in an hour of Poisson arrivals at 'stations'
+* stations, by the Allen-Cunneen formula for the M/G/c queue: the
+* Erlang C probability of waiting, from the Erlang B recursion, over
+* the rate at which the queue drains, times (1 + scv) / 2.  The formula
+* is for a queue that has settled, and it has no value once the hour
+* is full.  A full or over full hour is taken instead as a fluid
+* queue, whose backlog grows steadily through the hour, so the mean
+* wait of the hour's voters is half an hour for each unit of
+* utilization past one.
+*
+* Parameters:
+*    stations - the number of stations
+*    lambda - arrivals per second
+*    mean - the mean service time in seconds
+*    scv - the squared coefficient of variation of the service time
+*
+* Returns:
+*    the approximate mean wait in seconds
+**/
+static double ApproximateHourWait(int stations, double lambda, double mean,
+                                  double scv) {
+  const double kHour = 3600.0;
+  double offered = lambda * mean;
+  double utilization = offered / static_cast<double>(stations);
+  if (utilization >= 1.0) {
+    return 0.5 * kHour * (utilization - 1.0);
+  }
+
+  double wait = ErlangC(stations, offered)
+              / (static_cast<double>(stations) / mean - lambda)
+              * (1.0 + scv) / 2.0;
+
+  return wait;
+}
+
 /****************************************************************
 * Constructor.
 **/
@@ -52,193 +141,616 @@ OnePct::~OnePct() {
 * Accessors and mutators.
 **/
 
+/****************************************************************
+**/
+LONG OnePct::GetAllocationsReserving() const {
+  return allocations_reserving_;
+}
+
+/****************************************************************
+**/
+LONG OnePct::GetAllocationsSimulating() const {
+  return allocations_simulating_;
+}
+
+/****************************************************************
+**/
+string OnePct::GetEngineMismatch() const {
+  return engine_mismatch_;
+}
+
 /****************************************************************
 **/
 int OnePct::GetExpectedVoters() const {
   return pct_expected_voters_;
 }
 
+/****************************************************************
+**/
+int OnePct::GetIterationsRun() const {
+  return iterations_run_;
+}
+
 /****************************************************************
 **/
 int OnePct::GetPctNumber() const {
   return pct_number_;
 }
 
+/****************************************************************
+* Number of voters 'CreateVoters' makes for one population.  This does
+* not depend on the random numbers, only on the expected voters and
+* the arrival fractions.
+**/
+int OnePct::GetPopulationSize(const Configuration& config) const {
+  int population_size = round((config.arrival_zero_ / 100.0)
+                              * pct_expected_voters_);
+  for (int hour = 0; hour < config.election_day_length_hours_; ++hour) {
+    population_size += this->GetVotersThisHour(config, hour);
+  }
+  return population_size;
+}
+
+/****************************************************************
+* Number of voters 'CreateVoters' makes for one hour of the day.
+**/
+int OnePct::GetVotersThisHour(const Configuration& config, int hour) const {
+  double percent = config.arrival_fractions_.at(hour);
+  int voters_this_hour = round((percent / 100.0) * pct_expected_voters_);
+  if (0 == hour % 2)
+    ++voters_this_hour;
+  return voters_this_hour;
+}
+
+/****************************************************************
+* Estimated cost of simulating this precinct, in units of voters
+* simulated: the expected voters times the number of station counts
+* in the range that 'RunSimulationPct' may try.  This is only used to
+* decide the order in which precincts are started.
+**/
+LONG OnePct::GetEstimatedCost(const Configuration& config) const {
+  LONG station_range = this->GetMaxStationCount(config)
+                     - this->GetMinStationCount(config) + 1;
+  return static_cast<LONG>(pct_expected_voters_) * station_range;
+}
+
+/****************************************************************
+* Smallest station count worth simulating: the stations needed just
+* to keep up with the expected voters over the day, at least one.
+**/
+int OnePct::GetMinStationCount(const Configuration& config) const {
+  int min_station_count = pct_expected_voters_ 
+                        * config.time_to_vote_mean_seconds_
+                        / (config.election_day_length_hours_ * 3600);
+  if (min_station_count <= 0) {
+    min_station_count = 1;
+  }
+  return min_station_count;
+}
+
+/****************************************************************
+**/
+int OnePct::GetMaxStationCount(const Configuration& config) const {
+  return this->GetMinStationCount(config)
+       + config.election_day_length_hours_;
+}
+
 /****************************************************************
 * General functions.
 **/
 /******************************************************************************
-* Computes mean and standard deviation of the wait time.
+* Computes mean and standard deviation of the wait time from the
+* statistics kept as the voters started voting.  As always, these are
+* taken over 'pct_expected_voters_' rather than the number of voters
+* created, so the mean is the exact sum of the waits over that, and
+* the sum of squares about the mean of the voters is moved to be about
+* this mean instead.
 * pct_expected_voters_ must be greater than zero.
 **/
 void OnePct::ComputeMeanAndDev() {
-  multimap<int, OneVoter>::iterator iter_multimap;
+  double voters = static_cast<double>(wait_statistics_.GetCount());
+  double voters_mean = wait_statistics_.GetMeanSeconds();
+  wait_mean_seconds_ = static_cast<double>(wait_statistics_.GetSumSeconds())
+                     / static_cast<double>(pct_expected_voters_);
 
-  // We iterate through the vector and gather all of the voters waiting time.
-  // the times are then added up to get a sum. An average is found from that.
+  double shift = voters_mean - wait_mean_seconds_;
+  double sum_of_adjusted_times_seconds =
+      wait_statistics_.GetSumOfSquaredDeviations() + voters * shift * shift;
+  wait_dev_seconds_ = sqrt(sum_of_adjusted_times_seconds
+                    / static_cast<double>(pct_expected_voters_));
+}
 
-  int sum_of_wait_times_seconds = 0;
-  for (iter_multimap = voters_done_voting_.begin();
-       iter_multimap != voters_done_voting_.end(); ++iter_multimap) {
-    OneVoter voter = iter_multimap->second;
-    sum_of_wait_times_seconds += voter.GetTimeWaiting();
+/****************************************************************
+* Function 'ComputeMgcApproximation'
+*
+* Works out, for each hour and the given station count, the M/G/c
+* approximation of the mean wait and its slope with respect to the
+* mean service time, the slope by a central difference.  The voters
+* who all arrive at the opening are not a Poisson stream and are left
+* out of the arrival rate.
+*
+* Parameters:
+*    config - The configuration
+*    stations - the number of stations
+**/
+void OnePct::ComputeMgcApproximation(const Configuration& config,
+                                     int stations) {
+  const double kStep = 0.01;
+  double lower_mean = service_mean_seconds_ * (1.0 - kStep);
+  double upper_mean = service_mean_seconds_ * (1.0 + kStep);
+  for (UINT hour = 0; hour < mgc_wait_seconds_.size(); ++hour) {
+    double lambda = this->GetVotersThisHour(config, hour) / 3600.0;
+    mgc_wait_seconds_[hour] = ApproximateHourWait(stations, lambda,
+                                  service_mean_seconds_, service_scv_);
+    mgc_slope_[hour] =
+        (ApproximateHourWait(stations, lambda, upper_mean, service_scv_)
+         - ApproximateHourWait(stations, lambda, lower_mean, service_scv_))
+        / (upper_mean - lower_mean);
+    mgc_utilization_[hour] = lambda * service_mean_seconds_
+                           / static_cast<double>(stations);
   }
-  wait_mean_seconds_ = static_cast<double>(sum_of_wait_times_seconds)
-                     / static_cast<double>(pct_expected_voters_);
+}
 
-  // The process is slightly repeated. It iterates through the mulitmap and
-  // gets the voter at each iteration and finds the difference between that
-  // voters wait time and the mean wait time which is 'this_addin'. It is 
-  // then squared and then the wait_dev_seconds is found
+/****************************************************************
+* Function 'GetControl'
+*
+* Returns the control variate for the current population: the change
+* in the approximate mean wait over the expected voters, in minutes,
+* that the voters' actual service times in each hour would make, to
+* first order.  That is the slope of the hour's approximate wait times
+* how far the hour's total service time is from its expected value.
+* The service times are drawn independently of the arrivals, so
+* whatever the sampling the control has a mean of exactly zero, and a
+* population with long service times, which will wait long, has a
+* large control.
+*
+* Returns:
+*    the control variate
+**/
+double OnePct::GetControl() {
+  int hours = static_cast<int>(hour_voters_.size());
+  fill(hour_voters_.begin(), hour_voters_.end(), 0);
+  fill(hour_service_seconds_.begin(), hour_service_seconds_.end(), 0);
+  for (int voter = voters_first_; voter < voters_first_ + voters_count_;
+       ++voter) {
+    int hour = min(voter_arrival_[voter] / 3600, hours - 1);
+    ++hour_voters_[hour];
+    hour_service_seconds_[hour] += voter_duration_[voter];
+  }
 
-  double sum_of_adjusted_times_seconds = 0.0;
-  for (iter_multimap = voters_done_voting_.begin();
-       iter_multimap != voters_done_voting_.end(); ++iter_multimap) {
-    OneVoter voter = iter_multimap->second;
-    double this_addin = static_cast<double>(voter.GetTimeWaiting())
-                      - wait_mean_seconds_;
-    sum_of_adjusted_times_seconds += (this_addin) * (this_addin);
+  double control = 0.0;
+  for (int hour = 0; hour < hours; ++hour) {
+    control += mgc_slope_[hour]
+             * (static_cast<double>(hour_service_seconds_[hour])
+                - hour_voters_[hour] * service_mean_seconds_);
   }
-  wait_dev_seconds_ = sqrt(sum_of_adjusted_times_seconds
-                    / static_cast<double>(pct_expected_voters_));
+  return control / static_cast<double>(pct_expected_voters_) / 60.0;
+}
+
+/****************************************************************
+* Function 'ComputeServiceMoments'
+*
+* Computes the mean and squared coefficient of variation of the
+* measured service times, for the queueing approximations.
+*
+* Parameters:
+*    config - The configuration
+**/
+void OnePct::ComputeServiceMoments(const Configuration& config) {
+  double sum = 0.0;
+  double sum_of_squares = 0.0;
+  for (auto iter = config.actual_service_times_.begin();
+       iter != config.actual_service_times_.end(); ++iter) {
+    sum += *iter;
+    sum_of_squares += static_cast<double>(*iter) * (*iter);
+  }
+  double count = static_cast<double>(config.actual_service_times_.size());
+  service_mean_seconds_ = sum / count;
+  service_scv_ = (sum_of_squares / count
+                  - service_mean_seconds_ * service_mean_seconds_)
+               / (service_mean_seconds_ * service_mean_seconds_);
 }
 
 /****************************************************************
 * Function 'CreateVoters'
 *
-* This function creates a list of randomly generated voters
+* This function creates a list of randomly generated voters and adds
+* them as a new population at the end of the voter arrays.
+*
+* The random numbers for each hour are drawn in two batches, all the
+* interarrival times and then all the service times, into buffers that
+* are kept from one call to the next.  Service times come from the
+* configuration's 'ServiceTable', which draws from the measured times.
+*
+* With 'antithetic' sampling the service times are drawn by inverting
+* the distribution in pairs of voters, so that they, like the
+* interarrival times, move monotonically with the uniforms behind them
+* and an antithetic stream gives the mirror image population.  With
+* 'stratified' sampling each batch of service times has one from each
+* equal slice of probability.
 * 
 * Parameters:
 *    config - The configuration
+*    sampling - 'plain', 'antithetic', or 'stratified'
 *    random - An instance of the MyRandom class
 *    out_stream - The stream that we are using to write
 **/
-void OnePct::CreateVoters(const Configuration& config, MyRandom& random,
-                          ofstream& out_stream) {
+void OnePct::CreateVoters(const Configuration& config, const string& sampling,
+                          MyRandom& random, ostream& out_stream) {
   int duration = 0;
   int arrival = 0;
-  int sequence = 0;
+  int first = static_cast<int>(voter_arrival_.size());
   double percent = config.arrival_zero_;
   string outstring = "XX";
-  voters_backup_.clear();
   int voters_at_zero = round((percent / 100.0) * pct_expected_voters_);
 
-  // This loops through and gathers all the info needed to create and voter 
-  // such as the sequence, arrival, and duration. It then creates a voter
-  // based off such information and adds that voter to the backup map.
+  // This loops through and gathers all the info needed to create a voter,
+  // the arrival and the duration, and adds them to the voter arrays.
 
+  if (static_cast<int>(random_service_times_.size()) < voters_at_zero) {
+    random_service_times_.resize(voters_at_zero);
+  }
+  DrawServiceTimes(config.service_table_, sampling, random, voters_at_zero,
+                   random_service_times_.data());
   for (int voter = 0; voter < voters_at_zero; ++voter) {
-    int durationsub = random.RandomUniformInt(0,
-                          config.GetMaxServiceSubscript());
-    duration = config.actual_service_times_.at(durationsub);
-    OneVoter one_voter(sequence, arrival, duration);
-    voters_backup_.insert(std::pair<int, OneVoter>(arrival, one_voter));
-    ++sequence;
+    duration = random_service_times_[voter];
+    voter_arrival_.push_back(arrival);
+    voter_duration_.push_back(duration);
   }
 
   for (int hour = 0; hour < config.election_day_length_hours_; ++hour) {
-    percent = config.arrival_fractions_.at(hour);
-    int voters_this_hour = round((percent / 100.0) * pct_expected_voters_);
-    if (0 == hour % 2)
-      ++voters_this_hour;
+    int voters_this_hour = this->GetVotersThisHour(config, hour);
     int arrival = hour * 3600;
+
+    if (static_cast<int>(random_interarrivals_.size()) < voters_this_hour) {
+      random_interarrivals_.resize(voters_this_hour);
+    }
+    if (static_cast<int>(random_service_times_.size()) < voters_this_hour) {
+      random_service_times_.resize(voters_this_hour);
+    }
+    double lambda = static_cast<double>(voters_this_hour / 3600.0);
+    random.FillExponentialInt(lambda, voters_this_hour,
+                              random_interarrivals_.data());
+    DrawServiceTimes(config.service_table_, sampling, random,
+                     voters_this_hour, random_service_times_.data());
+
     for(int voter = 0; voter < voters_this_hour; ++voter) {
-      double lambda = static_cast<double>(voters_this_hour / 3600.0);
-      int interarrival = random.RandomExponentialInt(lambda);
-      arrival += interarrival;
-      int durationsub = random.RandomUniformInt(0,
-                            config.GetMaxServiceSubscript());
-      duration = config.actual_service_times_.at(durationsub);
+      arrival += random_interarrivals_[voter];
+      duration = random_service_times_[voter];
+
+      voter_arrival_.push_back(arrival);
+      voter_duration_.push_back(duration);
+    }
+  }
+
+  this->SortPopulation(first);
+  population_first_.push_back(static_cast<int>(voter_arrival_.size()));
+}
+
+/****************************************************************
+* Function 'ClearPopulations'
+*
+* Forgets all the voters, keeping the space they took.
+**/
+void OnePct::ClearPopulations() {
+  voter_arrival_.clear();
+  voter_duration_.clear();
+  population_first_.assign(1, 0);
+}
+
+/****************************************************************
+* Function 'ScreenStationCounts'
+*
+* Narrows the range of station counts to simulate, by approximations
+* that are good but are not guarantees.  Counts from the bottom whose
+* fluid wait is well over what is too long are taken as inadequate,
+* since the real queue, with random arrivals and service times, waits
+* longer still.  The first count at which the M/G/c approximation
+* expects far fewer than one voter to wait too long over all the
+* iterations, and whose fluid wait is well under what is too long, is
+* taken as sufficient, and so are all the counts above it.  The M/G/c
+* approximation leaves out the voters who arrive at the opening, who
+* wait the longest, and the fluid wait is only their average, so that
+* count is still simulated and only those above it are screened out.
+* Each count screened out is reported with its reason.
+*
+* Parameters:
+*    config - The configuration
+*    min_station_count - the smallest count to try, raised past the
+*                        inadequate counts
+*    max_station_count - the largest count to try, lowered to the
+*                        first sufficient count
+*    out_stream - The stream that we are using to write
+*
+* Returns:
+*    true if a count was found sufficient
+**/
+bool OnePct::ScreenStationCounts(const Configuration& config,
+                                 int& min_station_count,
+                                 int& max_station_count,
+                                 ostream& out_stream) const {
+  // how far past what is too long the fluid wait must be to rule a
+  // count out, how far under for it to be sufficient, and how few
+  // voters over all the iterations may be expected to wait too long
+  const double kInadequateMargin = 1.25;
+  const double kSufficientMargin = 0.5;
+  const double kSufficientExpected = 0.01;
+
+  double too_long_seconds = 60.0 * config.wait_time_minutes_that_is_too_long_;
+  int min_iterations = 0;
+  int max_iterations = 0;
+  this->GetIterationLimits(config, min_iterations, max_iterations);
+  int offset = 6;
+  string outstring = "";
+
+  int worst_hour = -1;
+  while (min_station_count <= max_station_count) {
+    double fluid_wait = this->GetFluidMaxWait(config, min_station_count,
+                                              worst_hour);
+    if (fluid_wait <= kInadequateMargin * too_long_seconds) {
+      break;
+    }
+    string when = "at opening";
+    if (worst_hour >= 0) {
+      when = "by " + Utils::Format(offset + worst_hour + 1, 2) + ":00";
+    }
+    outstring += kTag + "SCREEN " + Utils::Format(pct_number_, 4)
+               + Utils::Format(min_station_count, 4)
+               + " stations inadequate by approximation, fluid wait (mins) "
+               + Utils::Format(fluid_wait / 60.0, 8, 2) + " " + when + "\n";
+    ++min_station_count;
+  }
 
-      OneVoter one_voter(sequence, arrival, duration);
-      voters_backup_.insert(std::pair<int, OneVoter>(arrival, one_voter));
-      ++sequence;
+  bool found_sufficient = false;
+  for (int stations = min_station_count; stations <= max_station_count;
+       ++stations) {
+    double expected = this->GetExpectedTooLong(config, stations)
+                    * max_iterations;
+    double fluid_wait = this->GetFluidMaxWait(config, stations, worst_hour);
+    if ((expected <= kSufficientExpected) &&
+        (fluid_wait <= kSufficientMargin * too_long_seconds)) {
+      outstring += kTag + "SCREEN " + Utils::Format(pct_number_, 4)
+                 + Utils::Format(stations, 4)
+                 + " stations sufficient by approximation, expected too long "
+                 + Utils::Format(expected, 10, 6) + " in "
+                 + Utils::Format(max_iterations, 4)
+                 + " iterations, fluid wait (mins) "
+                 + Utils::Format(fluid_wait / 60.0, 8, 2) + "\n";
+      max_station_count = stations;
+      found_sufficient = true;
+      break;
     }
   }
+
+  outstring += kTag + "SCREEN " + Utils::Format(pct_number_, 4);
+  if (min_station_count <= max_station_count) {
+    outstring += " simulating stations "
+               + Utils::Format(min_station_count, 4) + " to "
+               + Utils::Format(max_station_count, 4) + "\n";
+  } else {
+    outstring += " simulating no stations\n";
+  }
+  out_stream << outstring;
+
+  return found_sufficient;
+} // bool OnePct::ScreenStationCounts(const Configuration& config, ...)
+
+/****************************************************************
+* Function 'SelectPopulation'
+*
+* Makes one of the populations the one to be simulated.
+*
+* Parameters:
+*    which - the population, numbered from 0 in order of creation
+**/
+void OnePct::SelectPopulation(int which) {
+  voters_first_ = population_first_.at(which);
+  voters_count_ = population_first_.at(which + 1) - voters_first_;
+}
+
+/****************************************************************
+* Function 'SortPopulation'
+*
+* Puts the newest population into order of arrival.  Each hour's voters
+* arrive in order, but the last of one hour can arrive after the first
+* of the next, so the population is a few sorted runs.  Voters who
+* arrive at the same second keep the order in which they were created.
+* The sort is on one 64-bit key per voter, the arrival time above the
+* place of creation, so no two keys are equal.
+*
+* Parameters:
+*    first - subscript of the first voter of the population
+**/
+void OnePct::SortPopulation(int first) {
+  int count = static_cast<int>(voter_arrival_.size()) - first;
+  int *arrival = voter_arrival_.data() + first;
+  int *duration = voter_duration_.data() + first;
+  if (is_sorted(arrival, arrival + count)) {
+    return;
+  }
+
+  voter_sort_keys_.resize(count);
+  for (int voter = 0; voter < count; ++voter) {
+    voter_sort_keys_[voter] = (static_cast<uint64_t>(arrival[voter]) << 32)
+                            | static_cast<uint64_t>(voter);
+  }
+  sort(voter_sort_keys_.begin(), voter_sort_keys_.end());
+
+  // the durations go through the service time buffer on their way
+  if (static_cast<int>(random_service_times_.size()) < count) {
+    random_service_times_.resize(count);
+  }
+  copy(duration, duration + count, random_service_times_.begin());
+  for (int voter = 0; voter < count; ++voter) {
+    uint64_t key = voter_sort_keys_[voter];
+    arrival[voter] = static_cast<int>(key >> 32);
+    duration[voter] = random_service_times_[key & 0xFFFFFFFFu];
+  }
 }
 
 /******************************************************************************
 * Function 'DoStatistics'
 * 
-* This function generates the data for a histogram based on the distribution
-* of voter wait times.  The mean and standard deviation of wait times is
-* computed by a call to 'ComputeMeanAndDev'.  The number of voters who waited
-* too long, 10 minutes too long, and 20 minutes too long is counted. This data
-* is printed.
+* This function adds the wait times of the last simulation, by minute,
+* to the histogram for this station count, and, if percentiles are
+* wanted, adds the sketches of the waits for each hour to those for
+* this station count.  The number of voters who
+* waited too long, 10 minutes too long, and 20 minutes too long, and the
+* mean and standard deviation of wait times, all come from the
+* statistics kept by the queue engine, and are formatted into 'line_'
+* for the caller to append to the report for this station count.
 * 
 * Parameters:
 *    iteration - The number of the current iteration
-*    config - The configuration
 *    station_count - The number of stations in this precinct
-*    map_for_histo - The Map instance in which to store the histogram data
-*    out_stream - The stream that we are using to write
+*    result - The results for this station count, to which the wait
+*             times are added
 *
 * Returns:
 *    The number of voters who waited too long.
 **/
-int OnePct::DoStatistics(int iteration, const Configuration& config,
-                         int station_count, map<int, int>& map_for_histo,
-                         ofstream& out_stream) {
-  string outstring = "\n";
-  map<int, int> wait_time_minutes_map;
-
+int OnePct::DoStatistics(int iteration, int station_count,
+                         StationCountResult& result) {
 /////////////////////////////////////////////////////////////////////////////
-  multimap<int, OneVoter>::iterator iter_multimap;
-  for (iter_multimap = this->voters_done_voting_.begin();
-       iter_multimap != this->voters_done_voting_.end(); ++iter_multimap) {
-    OneVoter voter = iter_multimap->second;
-    int wait_time_minutes = voter.GetTimeWaiting() / 60; // secs to mins
+  result.histogram.Merge(wait_statistics_.GetMinutes());
 
-    ++(wait_time_minutes_map[wait_time_minutes]);
-    ++(map_for_histo[wait_time_minutes]);
+  int hours = wait_statistics_.GetHours();
+  if (static_cast<int>(result.hour_sketches.size()) < hours) {
+    result.hour_sketches.resize(hours);
   }
-
-/////////////////////////////////////////////////////////////////////////////
-  int toolongcount = 0;
-  int toolongcountplus10 = 0;
-  int toolongcountplus20 = 0;
-  for (auto iter = wait_time_minutes_map.rbegin();
-       iter != wait_time_minutes_map.rend(); ++iter) {
-    int waittime = iter->first;
-    int waitcount = iter->second;
-    if (waittime > config.wait_time_minutes_that_is_too_long_)
-      toolongcount += waitcount;
-    if (waittime > config.wait_time_minutes_that_is_too_long_ + 10)
-      toolongcountplus10 += waitcount;
-    if (waittime > config.wait_time_minutes_that_is_too_long_ + 20)
-      toolongcountplus20 += waitcount;
+  for (int hour = 0; hour < hours; ++hour) {
+    result.hour_sketches[hour].Merge(wait_statistics_.GetHourSketch(hour));
   }
 
 /////////////////////////////////////////////////////////////////////////////
-  ComputeMeanAndDev();
-  outstring = "";
-  outstring += kTag + Utils::Format(iteration, 3) + " "
-            + Utils::Format(pct_number_, 4) + " "
-            + Utils::Format(pct_name_, 25, "left")
-            + Utils::Format(pct_expected_voters_, 6)
-            + Utils::Format(station_count, 4)
-            + " stations, mean/dev wait (mins) "
-            + Utils::Format(wait_mean_seconds_ / 60.0, 8, 2) + " "
-            + Utils::Format(wait_dev_seconds_ / 60.0, 8, 2)
-            + " toolong "
-            + Utils::Format(toolongcount, 6) + " "
-            + Utils::Format(100.0 * toolongcount
-                            / (double)pct_expected_voters_, 6, 2)
-            + Utils::Format(toolongcountplus10, 6) + " "
-            + Utils::Format(100.0 * toolongcountplus10
-                            / (double)pct_expected_voters_, 6, 2)
-            + Utils::Format(toolongcountplus20, 6) + " "
-            + Utils::Format(100.0 * toolongcountplus20
-                            / (double)pct_expected_voters_, 6, 2)
-            + "\n";
-
-  Utils::Output(outstring, out_stream, Utils::log_stream);
-
-  wait_time_minutes_map.clear();
+  int toolongcount = wait_statistics_.GetCountTooLong(0);
+  int toolongcountplus10 = wait_statistics_.GetCountTooLong(1);
+  int toolongcountplus20 = wait_statistics_.GetCountTooLong(2);
+
+  this->ComputeMeanAndDev();
+  line_.Clear();
+  line_.Append(kTag).Append(iteration, 3).Append(" ")
+       .Append(pct_number_, 4).Append(" ")
+       .Append(pct_name_, 25, "left")
+       .Append(pct_expected_voters_, 6)
+       .Append(station_count, 4)
+       .Append(" stations, mean/dev wait (mins) ")
+       .Append(wait_mean_seconds_ / 60.0, 8, 2).Append(" ")
+       .Append(wait_dev_seconds_ / 60.0, 8, 2)
+       .Append(" toolong ")
+       .Append(toolongcount, 6).Append(" ")
+       .Append(100.0 * toolongcount / (double)pct_expected_voters_, 6, 2)
+       .Append(toolongcountplus10, 6).Append(" ")
+       .Append(100.0 * toolongcountplus10 / (double)pct_expected_voters_, 6, 2)
+       .Append(toolongcountplus20, 6).Append(" ")
+       .Append(100.0 * toolongcountplus20 / (double)pct_expected_voters_, 6, 2)
+       .Append("\n");
 
   return toolongcount;
 }
 
+/****************************************************************
+* Function 'DoFluidStatistics'
+*
+* Works out the waits for one station count in a deterministic fluid
+* model of the day and adds a line with the same columns as the one
+* 'DoStatistics' writes for an iteration, marked 'APX' in place of
+* the iteration number and as approximate.
+*
+* In the model the voters who arrive at the opening all come at once
+* and the first 'station_count' of them start at once, and in each hour
+* voters arrive at the steady rate 'GetVotersThisHour' gives.  The
+* stations vote voters at the steady rate of 'station_count' over the
+* mean of the measured service times.  The queue is stepped a second
+* at a time, and a voter's wait is the queue ahead of it over that
+* rate.  With the randomness gone the queue builds only when an hour
+* is over full, so the waits are far shorter than simulated ones
+* unless the stations are overloaded, and counts of voters are
+* fractional.
+*
+* Parameters:
+*    config - The configuration
+*    station_count - the number of stations
+*    outstring - the line is added to this
+*
+* Returns:
+*    the number of voters who waited too long, rounded
+**/
+int OnePct::DoFluidStatistics(const Configuration& config,
+                              int station_count, string& outstring) const {
+  const int kTooLongLevels = 3;
+  double capacity = static_cast<double>(station_count)
+                  / service_mean_seconds_;
+  int too_long_minutes[kTooLongLevels];
+  for (int which = 0; which < kTooLongLevels; ++which) {
+    too_long_minutes[which] = config.wait_time_minutes_that_is_too_long_
+                            + 10 * which;
+  }
+
+  double voters = 0.0;
+  double sum_seconds = 0.0;
+  double sum_of_squares = 0.0;
+  double too_long[kTooLongLevels] = {0.0, 0.0, 0.0};
+
+  // the opening rush, one voter at a time
+  int voters_at_zero = round((config.arrival_zero_ / 100.0)
+                             * pct_expected_voters_);
+  for (int voter = station_count; voter < voters_at_zero; ++voter) {
+    double wait = (voter - station_count + 1) / capacity;
+    sum_seconds += wait;
+    sum_of_squares += wait * wait;
+    for (int which = 0; which < kTooLongLevels; ++which) {
+      if (static_cast<int>(wait) / 60 > too_long_minutes[which]) {
+        too_long[which] += 1.0;
+      }
+    }
+  }
+  voters += voters_at_zero;
+  double queue = max(0, voters_at_zero - station_count);
+
+  // then each hour's voters, a second's worth at a time
+  for (int hour = 0; hour < config.election_day_length_hours_; ++hour) {
+    double lambda = this->GetVotersThisHour(config, hour) / 3600.0;
+    for (int second = 0; second < 3600; ++second) {
+      queue = max(0.0, queue + lambda - capacity);
+      double wait = queue / capacity;
+      voters += lambda;
+      sum_seconds += lambda * wait;
+      sum_of_squares += lambda * wait * wait;
+      for (int which = 0; which < kTooLongLevels; ++which) {
+        if (static_cast<int>(wait) / 60 > too_long_minutes[which]) {
+          too_long[which] += lambda;
+        }
+      }
+    }
+  }
+
+  // as in 'ComputeMeanAndDev', over the expected voters
+  double expected = static_cast<double>(pct_expected_voters_);
+  double mean_seconds = sum_seconds / expected;
+  double squares = sum_of_squares - 2.0 * mean_seconds * sum_seconds
+                 + voters * mean_seconds * mean_seconds;
+  double dev_seconds = sqrt(max(0.0, squares) / expected);
+
+  FormatBuffer line;
+  line.Append(kTag).Append("APX ").Append(pct_number_, 4).Append(" ")
+      .Append(pct_name_, 25, "left")
+      .Append(pct_expected_voters_, 6)
+      .Append(station_count, 4)
+      .Append(" stations, approx mean/dev wait (mins) ")
+      .Append(mean_seconds / 60.0, 8, 2).Append(" ")
+      .Append(dev_seconds / 60.0, 8, 2)
+      .Append(" toolong ");
+  for (int which = 0; which < kTooLongLevels; ++which) {
+    line.Append(static_cast<int>(round(too_long[which])), 6).Append(" ")
+        .Append(100.0 * too_long[which] / expected, 6, 2);
+  }
+  line.Append("\n");
+  outstring += line.GetString();
+
+  return static_cast<int>(round(too_long[0]));
+}
+
 /****************************************************************
 * Function 'ReadData'
 * This sets all of the values in the file to the corresponding variables
@@ -267,15 +779,94 @@ void OnePct::ReadData(Scanner& infile) {
   }
 } // void OnePct::ReadData(Scanner& infile)
 
+/****************************************************************
+* Function 'ReadData'
+* The same, from one row of a binary precinct table.  A precinct read
+* again over an old one replaces it, so the old histogram stations go.
+*
+* Parameters:
+*    table - the precinct table
+*    row - the row of the table
+**/
+void OnePct::ReadData(const PctTable& table, int row) {
+  pct_number_ = table.GetNumber(row);
+  pct_name_ = table.GetName(row);
+  pct_turnout_ = table.GetTurnout(row);
+  pct_num_voters_ = table.GetNumVoters(row);
+  pct_expected_voters_ = table.GetExpectedVoters(row);
+  pct_expected_per_hour_ = table.GetExpectedPerHour(row);
+  pct_stations_ = table.GetStations(row);
+  pct_minority_ = table.GetMinority(row);
+
+  stations_to_histo_.clear();
+  for (int which = 0; which < PctTable::kHistoCount; ++which) {
+    stations_to_histo_.insert(table.GetHistoStations(row, which));
+  }
+} // void OnePct::ReadData(const PctTable& table, int row)
+
+/****************************************************************
+* Function 'RunFluidPct'
+*
+* The quick look: tries station counts upward over the same range as
+* the linear search in 'RunSimulationPct', with the fluid model of
+* 'DoFluidStatistics' in place of the simulation, and stops at the
+* first count at which no voter is expected to wait too long.  Every
+* line written is marked as approximate.
+*
+* Parameters:
+*    config - The configuration
+*    out_stream - The stream that we are using to write
+**/
+void OnePct::RunFluidPct(const Configuration& config, ostream& out_stream) {
+  int min_station_count = this->GetMinStationCount(config);
+  int max_station_count = this->GetMaxStationCount(config);
+
+  this->ComputeServiceMoments(config);
+  for (int stations_count = min_station_count;
+       stations_count <= max_station_count; ++stations_count) {
+    string outstring = kTag + this->ToString() + "\n";
+    int number_too_long = this->DoFluidStatistics(config, stations_count,
+                                                  outstring);
+    outstring += kTag + "toolong space filler\n";
+    out_stream << outstring;
+    if (0 == number_too_long) {
+      break;
+    }
+  }
+}
+
 /****************************************************************
 * Function 'RunSimulationPct'
 *
 * For a given precinct, determines the expected minimum and maximum
-* number of stations, and iterates across that range, calling
-* 'RunSimulationPct2' each time.  It calls the functions to calculate
-* statistics, and can optionally print a histogram of the wait times.
-* It terminates the iteration once the number of voters waiting too
-* long drops to zero.
+* number of stations, and searches that range for the smallest count
+* at which no voter waits too long, calling 'EvaluateStationCount' for
+* each count tried.  It can optionally print a histogram of the wait
+* times.
+*
+* The 'linear' search tries counts upward from the minimum and stops
+* at the first adequate one.  Since waits only fall as stations are
+* added, the 'bisect' search instead brackets the answer by doubling
+* the step above the minimum and then bisects the bracket.  It also
+* runs the counts in 'stations_to_histo_' that the linear search would
+* have reached, so the same HISTO blocks are printed.  Results are
+* printed in increasing order of station count.
+*
+* With the 'shared' population option each iteration's voters are
+* created only once, the first time any count reaches that iteration,
+* and every station count is run against those same populations
+* (common random numbers).
+*
+* With the screen on, counts that the queueing approximations show
+* to be inadequate, or more than sufficient, are reported as such and
+* not simulated, so the search runs over the counts left in between
+* and the first count taken as sufficient.  Counts screened out get
+* no HISTO block.
+*
+* Every population is drawn from its own random stream, chosen by the
+* precinct number, the station count (0 for shared populations), and
+* the iteration, so any precinct, count, or iteration can be rerun on
+* its own and give the same voters.
 * 
 * Parameters:
 *    config - The configuration
@@ -283,188 +874,1050 @@ void OnePct::ReadData(Scanner& infile) {
 *    out_stream - The stream that we are using to write
 **/
 void OnePct::RunSimulationPct(const Configuration& config,
-                              MyRandom& random, ofstream& out_stream) {
-  string outstring = "XX";
+                              MyRandom& random, ostream& out_stream) {
+  int min_station_count = this->GetMinStationCount(config);
+  int max_station_count = this->GetMaxStationCount(config);
 
-  int min_station_count = pct_expected_voters_ 
-                        * config.time_to_vote_mean_seconds_
-                        / (config.election_day_length_hours_ * 3600);
-  if (min_station_count <= 0) {
-    min_station_count = 1;
+  this->ReserveBuffers(config, random);
+  this->ClearPopulations();
+
+  if ("on" == config.screen_) {
+    this->ScreenStationCounts(config, min_station_count, max_station_count,
+                              out_stream);
+    if (min_station_count > max_station_count) {
+      return;
+    }
   }
-  int max_station_count = min_station_count
-                        + config.election_day_length_hours_;
 
-  bool done_with_this_count = false;
-  for (int stations_count = min_station_count;
-       stations_count <= max_station_count; ++stations_count) {
+  if ("bisect" != config.search_) {
+    for (int stations_count = min_station_count;
+         stations_count <= max_station_count; ++stations_count) {
+      StationCountResult result;
+      bool adequate = this->EvaluateStationCount(config, random,
+                                                 stations_count, result,
+                                                 out_stream);
+      this->OutputStationCount(config, stations_count, result, out_stream);
+      if (adequate) {
+        break;
+      }
+    }
+    return;
+  }
+
+  map<int, StationCountResult> results;
+  map<int, bool> adequate;
 
-    if (done_with_this_count) {
+  // bracket: the largest count known to be inadequate and the smallest
+  // known to be adequate, doubling the step until we pass the answer
+  int lower = min_station_count;
+  int upper = -1;
+  int step = 1;
+  int stations_count = min_station_count;
+  while (true) {
+    adequate[stations_count] = this->EvaluateStationCount(config, random,
+                                   stations_count, results[stations_count],
+                                   out_stream);
+    if (adequate[stations_count]) {
+      upper = stations_count;
       break;
     }
-    done_with_this_count = true;
-
-    map<int, int> map_for_histo;
+    lower = stations_count;
+    if (stations_count >= max_station_count) {
+      break;
+    }
+    stations_count = min_station_count + step;
+    if (stations_count > max_station_count) {
+      stations_count = max_station_count;
+    }
+    step *= 2;
+  }
 
-    outstring = kTag + this->ToString() + "\n";
-    Utils::Output(outstring, out_stream, Utils::log_stream);
-    for (int iteration = 0;
-         iteration < config.number_of_iterations_; ++iteration) {
-      this->CreateVoters(config, random, out_stream);
-      this->RunSimulationPct2(stations_count);
-      int number_too_long = DoStatistics(iteration, config, stations_count,
-                                         map_for_histo, out_stream);
-      if (number_too_long > 0) {
-        done_with_this_count = false;
+  // bisect the bracket
+  if ((upper > 0) && (upper > min_station_count)) {
+    while (upper - lower > 1) {
+      stations_count = lower + (upper - lower) / 2;
+      adequate[stations_count] = this->EvaluateStationCount(config, random,
+                                     stations_count,
+                                     results[stations_count], out_stream);
+      if (adequate[stations_count]) {
+        upper = stations_count;
+      } else {
+        lower = stations_count;
       }
     }
+  }
 
-    voters_voting_.clear();
-    voters_done_voting_.clear();
+  // the linear search would have printed histograms up to the answer
+  int last_station_count = (upper > 0) ? upper : max_station_count;
+  for (auto iter = stations_to_histo_.begin();
+       iter != stations_to_histo_.end(); ++iter) {
+    stations_count = *iter;
+    if ((stations_count < min_station_count) ||
+        (stations_count > last_station_count) ||
+        (results.count(stations_count) > 0)) {
+      continue;
+    }
+    adequate[stations_count] = this->EvaluateStationCount(config, random,
+                                   stations_count, results[stations_count],
+                                   out_stream);
+  }
 
-    outstring = kTag + "toolong space filler\n";
-    Utils::Output(outstring, out_stream, Utils::log_stream);
+  for (auto iter = results.begin(); iter != results.end(); ++iter) {
+    this->OutputStationCount(config, iter->first, iter->second, out_stream);
+  }
+}
 
-    if (stations_to_histo_.count(stations_count) > 0) {
-      outstring = "\n" + kTag + "HISTO " + this->ToString() + "\n";
-      outstring += kTag + "HISTO STATIONS "
-                + Utils::Format(stations_count, 4) + "\n";
-      Utils::Output(outstring, out_stream, Utils::log_stream);
+/****************************************************************
+* Function 'EvaluateStationCount'
+*
+* Runs the iterations for one station count and collects their
+* statistics.  With fresh populations a new set of voters is created
+* for every iteration, from the stream for this precinct, station
+* count, and iteration; with shared populations iteration 'i' is run
+* against population 'i', which is created from the stream for this
+* precinct and iteration if no count has needed it yet.  Creating,
+* simulating, and taking the statistics of an iteration should make
+* no heap allocations once 'ReserveBuffers' has been called; any they
+* do make are counted in 'allocations_simulating_'.  The report line
+* for the iteration is added to the results after the count.
+*
+* With 'antithetic' sampling the iterations go in pairs: the second of
+* each pair uses the complement of the first one's stream, and it is
+* the pair's average that counts as one independent estimate.
+*
+* With 'fixed' iterations the configured number of iterations is run.
+* With 'adaptive' iterations that many are run at least, and then more
+* until the confidence interval on the mean over iterations of the
+* chosen measure, the fraction of voters who waited too long or the
+* mean wait, is no wider than asked, or the cap is reached.
+*
+* If a plain baseline was asked for, each iteration is followed by
+* one with plain sampling and its own voters, which adds only to the
+* baseline measure and not to the results.
+* 
+* Parameters:
+*    config - The configuration
+*    random - An instance of the MyRandom class
+*    stations_count - number of stations to use in this simulation
+*    result - The results for this station count, to be filled in
+*    out_stream - The stream that we are using to write
+*
+* Returns:
+*    true if no voter waited too long in any iteration
+**/
+bool OnePct::EvaluateStationCount(const Configuration& config,
+                   MyRandom& random, int stations_count,
+                   StationCountResult& result, ostream& out_stream) {
+  bool adequate = true;
+  bool antithetic = ("antithetic" == config.sampling_);
+  int min_iterations = 0;
+  int max_iterations = 0;
+  this->GetIterationLimits(config, min_iterations, max_iterations);
+  bool control = ("on" == config.control_variate_);
+  if (control) {
+    this->ComputeMgcApproximation(config, stations_count);
+  }
 
-      int time_lower = (map_for_histo.begin())->first;
-      int time_upper = (map_for_histo.rbegin())->first;
+  // sized before the iterations, so that taking their statistics
+  // allocates nothing
+  result.histogram.SetBinCount(wait_statistics_.GetMinutes().GetBinCount());
+  result.hour_sketches.resize(wait_statistics_.GetHours());
 
-      int voters_per_star = 1;
-      if (map_for_histo[time_lower] > 50) {
-        voters_per_star = map_for_histo[time_lower]
-                        / (50 * config.number_of_iterations_);
-        if (voters_per_star <= 0)
-          voters_per_star = 1;
+  for (int iteration = 0; iteration < max_iterations; ++iteration) {
+    LONG allocations_before = AllocationCounter::GetCount();
+    if ("shared" == config.population_) {
+      while (static_cast<int>(population_first_.size()) - 1 <= iteration) {
+        int population = static_cast<int>(population_first_.size()) - 1;
+        if (antithetic && (1 == population % 2)) {
+          random.SelectAntitheticStream(pct_number_, 0, population - 1);
+        } else {
+          random.SelectStream(pct_number_, 0, population);
+        }
+        this->CreateVoters(config, config.sampling_, random, out_stream);
       }
+      this->SelectPopulation(iteration);
+    } else {
+      this->ClearPopulations();
+      if (antithetic && (1 == iteration % 2)) {
+        random.SelectAntitheticStream(pct_number_, stations_count,
+                                      iteration - 1);
+      } else {
+        random.SelectStream(pct_number_, stations_count, iteration);
+      }
+      this->CreateVoters(config, config.sampling_, random, out_stream);
+      this->SelectPopulation(0);
+    }
+    this->SimulateStations(config, stations_count);
+    int number_too_long = DoStatistics(iteration, stations_count, result);
+    allocations_simulating_ += AllocationCounter::GetCount()
+                             - allocations_before;
+    ++iterations_run_;
+
+    // the report grows with every iteration, so it is added to only
+    // once the allocations have been counted
+    result.report += line_.GetString();
+    if (number_too_long > 0) {
+      adequate = false;
+    }
+
+    ++result.iterations;
+    double measure = this->GetMeasure(config, number_too_long);
+    result.measure.Add(measure);
+    if (!antithetic) {
+      result.units.Add(measure);
+    } else if (0 == iteration % 2) {
+      result.pair_first = measure;
+    } else {
+      result.units.Add((result.pair_first + measure) / 2.0);
+    }
 
-      for (int time = time_lower; time <= time_upper; ++time) {
-        int count = map_for_histo[time];
+    if (control) {
+      double wait = wait_mean_seconds_ / 60.0;
+      double control_value = this->GetControl();
+      if (!antithetic) {
+        result.control.Add(wait, control_value);
+      } else if (0 == iteration % 2) {
+        result.pair_first_wait = wait;
+        result.pair_first_control = control_value;
+      } else {
+        result.control.Add((result.pair_first_wait + wait) / 2.0,
+                           (result.pair_first_control + control_value) / 2.0);
+      }
+    }
 
-        double count_double = static_cast<double>(count) /
-        static_cast<double>(config.number_of_iterations_);
-        int count_divided_ceiling = static_cast<int>(ceil(count_double
-                                                          / voters_per_star));
-        string stars = string(count_divided_ceiling, '*');
+    if ("on" == config.sampling_baseline_) {
+      this->ClearPopulations();
+      random.SelectStream(pct_number_, stations_count, iteration);
+      this->CreateVoters(config, "plain", random, out_stream);
+      this->SelectPopulation(0);
+      this->SimulateStations(config, stations_count);
+      result.baseline.Add(this->GetMeasure(config,
+                              wait_statistics_.GetCountTooLong(0)));
+    }
 
-        outstring = kTag + "HISTO " + Utils::Format(time, 6) + ": "
-                  + Utils::Format(count_double, 7, 2) + ": ";
-        outstring += stars + "\n";
-        Utils::Output(outstring, out_stream, Utils::log_stream);
+    double half_width = this->GetHalfWidth(result.units);
+    if (control && ("wait" == config.ci_measure_)) {
+      half_width = HUGE_VAL;
+      if (result.control.count > 2) {
+        half_width = this->GetStudentT(result.control.count - 2)
+                   * sqrt(result.control.GetAdjustedVarianceOfMean());
       }
-      outstring = "HISTO\n\n";
-      Utils::Output(outstring, out_stream, Utils::log_stream);
     }
+    if (("adaptive" == config.iterations_) &&
+        (result.iterations >= min_iterations) &&
+        (!antithetic || (1 == iteration % 2)) &&
+        (half_width <= config.ci_half_width_)) {
+      break;
+    }
+  }
+
+  if ("adaptive" == config.iterations_) {
+    result.report += kTag + "ADAPTIVE " + Utils::Format(pct_number_, 4)
+                   + Utils::Format(stations_count, 4) + " stations "
+                   + Utils::Format(result.iterations, 5) + " iterations, "
+                   + config.ci_measure_ + " mean "
+                   + Utils::Format(result.units.mean, 10, 4)
+                   + " 95% half-width "
+                   + Utils::Format(this->GetHalfWidth(result.units), 10, 4)
+                   + " target "
+                   + Utils::Format(config.ci_half_width_, 10, 4) + "\n";
+  }
+  if (("plain" != config.sampling_) || ("on" == config.sampling_baseline_)) {
+    result.report += this->ToStringSampling(config, stations_count, result);
+  }
+  if (control) {
+    result.report += this->ToStringControl(stations_count, result);
+  }
+
+  return adequate;
+} // bool OnePct::EvaluateStationCount(const Configuration& config, ...)
+
+/****************************************************************
+* Function 'GetExpectedTooLong'
+*
+* Approximate number of voters in one iteration who wait too long at
+* the given station count, taking each hour as a settled M/G/c queue.
+* The chance of waiting longer than 't' is the Erlang C probability of
+* waiting times a tail that falls off with the rate at which the queue
+* drains, slowed by the variability of the service times as in the
+* Allen-Cunneen approximation.  The opening rush is not included.
+*
+* Parameters:
+*    config - The configuration
+*    stations - the number of stations
+*
+* Returns:
+*    the expected number, or HUGE_VAL if some hour is over full
+**/
+double OnePct::GetExpectedTooLong(const Configuration& config,
+                                  int stations) const {
+  double too_long_seconds = 60.0 * config.wait_time_minutes_that_is_too_long_;
+  double expected = 0.0;
+  for (int hour = 0; hour < config.election_day_length_hours_; ++hour) {
+    int voters_this_hour = this->GetVotersThisHour(config, hour);
+    double lambda = voters_this_hour / 3600.0;
+    double offered = lambda * service_mean_seconds_;
+    if (offered >= static_cast<double>(stations)) {
+      return HUGE_VAL;
+    }
+    double decay = (static_cast<double>(stations) / service_mean_seconds_
+                    - lambda) * 2.0 / (1.0 + service_scv_);
+    expected += voters_this_hour * ErlangC(stations, offered)
+              * exp(-decay * too_long_seconds);
+  }
+  return expected;
+}
+
+/****************************************************************
+* Function 'GetFluidMaxWait'
+*
+* Longest wait in a fluid model of the day, in which the voters who
+* arrive at the opening are a single lump and those in each hour
+* arrive at a steady rate, and the stations vote voters at a steady
+* rate of 'stations' over the mean service time.  The backlog changes
+* linearly within each hour, so its largest value is at the opening
+* or at the end of some hour.  A real queue, with random arrivals and
+* service times, waits longer than the fluid one.
+*
+* Parameters:
+*    config - The configuration
+*    stations - the number of stations
+*    worst_hour - set to the hour at whose end the wait is longest, or
+*                 -1 if it is longest at the opening
+*
+* Returns:
+*    the longest wait, in seconds
+**/
+double OnePct::GetFluidMaxWait(const Configuration& config, int stations,
+                               int& worst_hour) const {
+  double capacity = static_cast<double>(stations) / service_mean_seconds_;
+  int voters_at_zero = round((config.arrival_zero_ / 100.0)
+                             * pct_expected_voters_);
+
+  double backlog = max(0, voters_at_zero - stations);
+  double max_wait = backlog / capacity;
+  worst_hour = -1;
+  for (int hour = 0; hour < config.election_day_length_hours_; ++hour) {
+    double lambda = this->GetVotersThisHour(config, hour) / 3600.0;
+    backlog = max(0.0, backlog + (lambda - capacity) * 3600.0);
+    if (backlog / capacity > max_wait) {
+      max_wait = backlog / capacity;
+      worst_hour = hour;
+    }
+  }
+  return max_wait;
+}
+
+/****************************************************************
+* Function 'GetHalfWidth'
+*
+* Returns the half-width of the 95% confidence interval on the mean
+* of a measure, from Student's t distribution.  With no spread in the
+* measure, as when no voter ever waits too long, the width is zero.
+*
+* Parameters:
+*    measure - The running mean and squares of the measure
+*
+* Returns:
+*    the half-width, in the units of the measure
+**/
+double OnePct::GetHalfWidth(const RunningMeasure& measure) const {
+  int degrees = measure.count - 1;
+  if (degrees < 1) {
+    return HUGE_VAL;
+  }
+  return this->GetStudentT(degrees) * sqrt(measure.GetVarianceOfMean());
+}
+
+/****************************************************************
+* Function 'GetIterationLimits'
+*
+* Works out the fewest and most iterations to run for a station
+* count.  Antithetic iterations go in pairs, so both are rounded up to
+* a whole number of pairs.
+*
+* Parameters:
+*    config - The configuration
+*    min_iterations - set to the fewest iterations to run
+*    max_iterations - set to the most iterations to run
+**/
+void OnePct::GetIterationLimits(const Configuration& config,
+                                int& min_iterations,
+                                int& max_iterations) const {
+  min_iterations = config.number_of_iterations_;
+  max_iterations = config.number_of_iterations_;
+  if ("adaptive" == config.iterations_) {
+    if (min_iterations < 2) {
+      min_iterations = 2;
+    }
+    max_iterations = config.max_iterations_;
+  }
+  if ("antithetic" == config.sampling_) {
+    min_iterations += min_iterations % 2;
+    max_iterations += max_iterations % 2;
+  }
+}
+
+/****************************************************************
+* Function 'GetMeasure'
+*
+* Returns the measure the iterations are judged by for the last
+* simulation: the fraction of the expected voters who waited too long,
+* or the mean wait in minutes.
+*
+* Parameters:
+*    config - The configuration
+*    number_too_long - the number of voters who waited too long
+*
+* Returns:
+*    the measure
+**/
+double OnePct::GetMeasure(const Configuration& config,
+                          int number_too_long) const {
+  if ("wait" == config.ci_measure_) {
+    return static_cast<double>(wait_statistics_.GetSumSeconds())
+         / static_cast<double>(pct_expected_voters_) / 60.0;
+  }
+  return static_cast<double>(number_too_long)
+       / static_cast<double>(pct_expected_voters_);
+}
+
+/****************************************************************
+* Function 'GetStudentT'
+*
+* Parameters:
+*    degrees - the degrees of freedom, at least one
+*
+* Returns:
+*    the 97.5% point of Student's t distribution, the normal one past
+*    thirty degrees of freedom
+**/
+double OnePct::GetStudentT(int degrees) const {
+  // t(0.975) for 1 through 30 degrees of freedom
+  static const double kStudentT[30] = {
+    12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+    2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+    2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042 };
+
+  return (degrees <= 30) ? kStudentT[degrees - 1] : 1.960;
+}
+
+/****************************************************************
+* Function 'ControlVariate::Add'
+*
+* Adds one wait and its control to the running means and co-moments,
+* by Welford's method.
+*
+* Parameters:
+*    wait - the mean wait
+*    control - the control variate
+**/
+void OnePct::ControlVariate::Add(double wait, double control) {
+  ++count;
+  double wait_delta = wait - wait_mean;
+  double control_delta = control - control_mean;
+  wait_mean += wait_delta / static_cast<double>(count);
+  control_mean += control_delta / static_cast<double>(count);
+  wait_squares += wait_delta * (wait - wait_mean);
+  control_squares += control_delta * (control - control_mean);
+  cross += wait_delta * (control - control_mean);
+}
+
+/****************************************************************
+* Function 'ControlVariate::GetAdjustedMean'
+*
+* Returns:
+*    the mean wait less the coefficient times the mean control, which
+*    moves the mean wait back by as much as the control says the
+*    iterations' service times pushed it
+**/
+double OnePct::ControlVariate::GetAdjustedMean() const {
+  return wait_mean - this->GetCoefficient() * control_mean;
+}
+
+/****************************************************************
+* Function 'ControlVariate::GetAdjustedVarianceOfMean'
+*
+* Returns:
+*    the estimated variance of the adjusted mean: the variance of the
+*    waits about the regression line on the control, over the count
+*    less two, times the variance of the line's value at a control of
+*    zero; with no spread in the control this is the plain variance
+*    of the mean, and with fewer than three values it is zero
+**/
+double OnePct::ControlVariate::GetAdjustedVarianceOfMean() const {
+  if (count < 3) {
+    return 0.0;
+  }
+  if (control_squares <= 0.0) {
+    return wait_squares / static_cast<double>(count - 1)
+         / static_cast<double>(count);
+  }
+  double residual = max(0.0, wait_squares - this->GetCoefficient() * cross)
+                  / static_cast<double>(count - 2);
+  return residual * (1.0 / static_cast<double>(count)
+                     + control_mean * control_mean / control_squares);
+}
+
+/****************************************************************
+* Function 'ControlVariate::GetCoefficient'
+*
+* Returns:
+*    the least squares slope of the waits on the controls, or zero if
+*    the controls have no spread
+**/
+double OnePct::ControlVariate::GetCoefficient() const {
+  if (control_squares <= 0.0) {
+    return 0.0;
+  }
+  return cross / control_squares;
+}
+
+/****************************************************************
+* Function 'RunningMeasure::Add'
+*
+* Adds one value to the running mean and squares, by Welford's method.
+*
+* Parameters:
+*    measure - the value
+**/
+void OnePct::RunningMeasure::Add(double measure) {
+  ++count;
+  double delta = measure - mean;
+  mean += delta / static_cast<double>(count);
+  squares += delta * (measure - mean);
+}
+
+/****************************************************************
+* Function 'RunningMeasure::GetVarianceOfMean'
+*
+* Returns:
+*    the estimated variance of the mean of the values so far, or zero
+*    if there are fewer than two
+**/
+double OnePct::RunningMeasure::GetVarianceOfMean() const {
+  if (count < 2) {
+    return 0.0;
+  }
+  return squares / static_cast<double>(count - 1)
+       / static_cast<double>(count);
+}
+
+/****************************************************************
+* Function 'OutputStationCount'
+*
+* Writes the results for one station count: the precinct header, the
+* statistics line from each iteration, the percentiles of the waits if
+* they were wanted, and, if this is one of the counts listed in
+* 'stations_to_histo_', the histogram of wait times.
+* 
+* Parameters:
+*    config - The configuration
+*    stations_count - The number of stations these results are for
+*    result - The statistics lines from 'DoStatistics', the wait time
+*             counts, and the wait sketches, summed over the iterations
+*    out_stream - The stream that we are using to write
+**/
+void OnePct::OutputStationCount(const Configuration& config,
+                                int stations_count,
+                                const StationCountResult& result,
+                                ostream& out_stream) {
+  string outstring = "XX";
+  const Histogram& histogram = result.histogram;
+
+  outstring = kTag + this->ToString() + "\n";
+  outstring += result.report;
+  out_stream << outstring;
+
+  if ("on" == config.percentiles_) {
+    out_stream << this->ToStringPercentiles(stations_count, result);
+  }
+
+  outstring = kTag + "toolong space filler\n";
+  out_stream << outstring;
+
+  if (stations_to_histo_.count(stations_count) > 0) {
+    outstring = "\n" + kTag + "HISTO " + this->ToString() + "\n";
+    outstring += kTag + "HISTO STATIONS "
+              + Utils::Format(stations_count, 4) + "\n";
+    out_stream << outstring;
+
+    int time_lower = histogram.GetMinValue();
+    int time_upper = histogram.GetMaxValue();
+
+    int voters_per_star = 1;
+    if (histogram.GetCount(time_lower) > 50) {
+      voters_per_star = histogram.GetCount(time_lower)
+                      / (50 * result.iterations);
+      if (voters_per_star <= 0)
+        voters_per_star = 1;
+    }
+
+    // an empty histogram has both limits -1 and prints no lines
+    for (int time = time_lower; time <= time_upper; ++time) {
+      int count = histogram.GetCount(time);
+
+      double count_double = static_cast<double>(count) /
+      static_cast<double>(result.iterations);
+      int count_divided_ceiling = static_cast<int>(ceil(count_double
+                                                        / voters_per_star));
+      string stars = string(count_divided_ceiling, '*');
+
+      line_.Clear();
+      line_.Append(kTag).Append("HISTO ").Append(time, 6).Append(": ")
+           .Append(count_double, 7, 2).Append(": ");
+      line_.Append(stars).Append("\n");
+      out_stream << line_.GetString();
+    }
+
+    // waits too long for the histogram are shown together
+    if (histogram.GetOverflowCount() > 0) {
+      double count_double = static_cast<double>(histogram.GetOverflowCount())
+                          / static_cast<double>(result.iterations);
+      int count_divided_ceiling = static_cast<int>(ceil(count_double
+                                                        / voters_per_star));
+      string longest = ">" + Utils::Format(histogram.GetBinCount() - 1);
+      outstring = kTag + "HISTO " + Utils::Format(longest, 6) + ": "
+                + Utils::Format(count_double, 7, 2) + ": ";
+      outstring += string(count_divided_ceiling, '*') + "\n";
+      out_stream << outstring;
+    }
+    outstring = "HISTO\n\n";
+    out_stream << outstring;
+  }
+} // void OnePct::OutputStationCount(const Configuration& config, ...)
+
+/****************************************************************
+* Function 'ReserveBuffers'
+*
+* Sizes every working buffer for the largest thing it will hold, so
+* that the iterations and station counts of this precinct all reuse
+* the same space.  The number of voters in a population is known in
+* advance from the expected voters, and no more voters than stations
+* are ever at a station at once.  The counts by minute have a bin for
+* every wait up to twice the length of the election day, which should
+* be far more than enough; longer waits share the overflow bin.
+*
+* Parameters:
+*    config - The configuration
+*    random - the random number generator this precinct will use
+**/
+void OnePct::ReserveBuffers(const Configuration& config, MyRandom& random) {
+  LONG allocations_before = AllocationCounter::GetCount();
+
+  int population_size = this->GetPopulationSize(config);
+  int populations_kept = 1;
+  if ("shared" == config.population_) {
+    int min_iterations = 0;
+    this->GetIterationLimits(config, min_iterations, populations_kept);
   }
+  int max_station_count = this->GetMaxStationCount(config);
 
+  population_first_.reserve(populations_kept + 1);
+  voter_arrival_.reserve(static_cast<size_t>(population_size)
+                         * populations_kept);
+  voter_duration_.reserve(static_cast<size_t>(population_size)
+                          * populations_kept);
+  voter_sort_keys_.reserve(population_size);
+  if (static_cast<int>(random_service_times_.size()) < population_size) {
+    random_service_times_.resize(population_size);
+  }
+  if (static_cast<int>(random_interarrivals_.size()) < population_size) {
+    random_interarrivals_.resize(population_size);
+  }
+  random.Reserve(population_size);
+
+  free_stations_.reserve(max_station_count);
+  voters_voting_.reserve(max_station_count);
+  stations_free_.reserve(max_station_count);
+  this->ComputeServiceMoments(config);
+  if ("on" == config.control_variate_) {
+    int hours = config.election_day_length_hours_;
+    hour_voters_.assign(hours, 0);
+    hour_service_seconds_.assign(hours, 0);
+    mgc_wait_seconds_.assign(hours, 0.0);
+    mgc_slope_.assign(hours, 0.0);
+    mgc_utilization_.assign(hours, 0.0);
+  }
+  if ("on" == config.percentiles_) {
+    wait_statistics_.SetHours(config.election_day_length_hours_);
+  } else {
+    wait_statistics_.SetHours(0);
+  }
+  wait_statistics_.SetMaxMinutes(2 * config.election_day_length_seconds_
+                                 / 60);
+
+  // room for the statistics line 'DoStatistics' builds, which is not
+  // much over 150 characters with any precinct name we have
+  line_.Reserve(256);
+
+  allocations_reserving_ += AllocationCounter::GetCount() - allocations_before;
 }
 
 /****************************************************************
 * Function 'RunSimulationPct2'
 *
 * Simulates a single precinct for a given number of stations.  First,
-* it restores the list of pending voters and frees all stations. Then it
-* iterates through time, adds voters to the waiting list as they arrive,
-* and keeps track of which stations are free or occupied. The
-* 'voters_done_voting_' records the time each voter completes the process.
+* it frees all stations. Then it moves through the day one event at a
+* time, adds voters to the stations as they arrive, and keeps track of
+* which stations are free or occupied.  Each voter's wait goes into
+* 'wait_statistics_' as the voter starts.
+*
+* The voters still to arrive are simply those past 'next_voter' in the
+* arrival order.  The voters at a station are a heap on the time they
+* leave, ties going to the one who started first, and the free stations
+* are a ring of 'stations_count' entries in the order they were freed.
+*
+* Nothing can change between a departure and the next departure or
+* arrival, so rather than stepping one second at a time we jump the
+* clock directly to the next time at which something can happen:
+* the earliest time a voter finishes, or, if a station is free, the
+* arrival of the next pending voter.  Departures at a given second are
+* processed before arrivals at that second, and free stations are
+* handed out in the order in which they were freed, so the results are
+* the same as those of a second-by-second scan.
 * 
 * Parameters:
 *    stations_count - number of stations to use in this simulation
 **/
 void OnePct::RunSimulationPct2(int stations_count) {
-  voters_pending_ = voters_backup_;
+  const int *arrival = voter_arrival_.data() + voters_first_;
+  const int *duration = voter_duration_.data() + voters_first_;
+  greater<VoterLeaving> later;
+
   voters_voting_.clear();
-  voters_done_voting_.clear();
-  free_stations_.clear();
+  free_stations_.resize(stations_count);
   for (int i = 0; i < stations_count; ++i) {
-    free_stations_.push_back(i);
+    free_stations_[i] = i;
   } 
+  int free_first = 0;
+  int free_count = stations_count;
+
+  int next_voter = 0;
+  int order_started = 0;
   int second = 0;
 
-  while ((voters_pending_.size() > 0) || (voters_voting_.size() > 0)) {
-    for (auto iter = voters_voting_.begin();
-         iter != voters_voting_.end(); ++iter) {
-      if (second == iter->first) {
-        OneVoter one_voter = iter->second;
+  while ((next_voter < voters_count_) || (voters_voting_.size() > 0)) {
+    // voters finishing now free up their stations
+    while ((voters_voting_.size() > 0) &&
+           (std::get<0>(voters_voting_.front()) == second)) {
+      int which_station = std::get<2>(voters_voting_.front());
+      pop_heap(voters_voting_.begin(), voters_voting_.end(), later);
+      voters_voting_.pop_back();
 
-        int which_station = one_voter.GetStationNumber();
-        free_stations_.push_back(which_station);
-        voters_done_voting_.insert(std::pair<int,
-                                   OneVoter>(second, one_voter));
-      }
+      free_stations_[(free_first + free_count) % stations_count]
+          = which_station;
+      ++free_count;
     }
-    voters_voting_.erase(second);
-
-    vector<map<int, OneVoter>::iterator > voters_pending_to_erase_by_iterator;
-    for (auto iter = voters_pending_.begin();
-         iter != voters_pending_.end(); ++iter) {
-      if (second >= iter->first) {       // if they have already arrived
-        if (free_stations_.size() > 0) { // and there are free stations
-          OneVoter next_voter = iter->second;
-          if (next_voter.GetTimeArrival() <= second) {
-            int which_station = free_stations_.at(0);
-            free_stations_.erase(free_stations_.begin());
-            next_voter.AssignStation(which_station, second);
-            int leave_time = next_voter.GetTimeDoneVoting();
-            voters_voting_.insert(std::pair<int, OneVoter>(leave_time,
-                                                           next_voter));
-            voters_pending_to_erase_by_iterator.push_back(iter);
-          } // if (next_voter.GetTimeArrival() <= second) {
-        } // if (free_stations_.size() > 0) {
-      } else { // if (second == iter->first) {
-        break; // walked in time past current time to arrivals in the future
+
+    // voters who have already arrived take the free stations in order
+    while ((free_count > 0) && (next_voter < voters_count_) &&
+           (arrival[next_voter] <= second)) {
+      int which_station = free_stations_[free_first];
+      free_first = (free_first + 1) % stations_count;
+      --free_count;
+      wait_statistics_.Add(second - arrival[next_voter], arrival[next_voter]);
+      start_checksum_ = (start_checksum_
+                         ^ ((static_cast<uint64_t>(second) << 20)
+                            | static_cast<uint64_t>(which_station)))
+                      * kChecksumPrime;
+      voters_voting_.push_back(VoterLeaving(second + duration[next_voter],
+                                            order_started, which_station));
+      push_heap(voters_voting_.begin(), voters_voting_.end(), later);
+      ++order_started;
+      ++next_voter;
+    }
+
+    // advance the clock to the next departure or usable arrival
+    int next_second = -1;
+    if (voters_voting_.size() > 0) {
+      next_second = std::get<0>(voters_voting_.front());
+    }
+    if ((free_count > 0) && (next_voter < voters_count_)) {
+      int next_arrival = arrival[next_voter];
+      if ((next_second < 0) || (next_arrival < next_second)) {
+        next_second = next_arrival;
       }
-    } // for (auto iter = voters_pending_.begin();
+    }
+    if (next_second < 0) {
+      break;
+    }
+    second = next_second;
+  } // while ((next_voter < voters_count_) || (voters_voting_.size() > 0)) {
 
-    for (auto iter = voters_pending_to_erase_by_iterator.begin();
-         iter != voters_pending_to_erase_by_iterator.end(); ++iter) {
-      voters_pending_.erase(*iter);
+} // void OnePct::RunSimulationPct2(int stations_count)
+
+/****************************************************************
+* Function 'RunSimulationPctFifo'
+*
+* Fast path for the same model as 'RunSimulationPct2'.  Voters are
+* served first come first served by identical stations, so each voter
+* starts at the later of the arrival time and the earliest time any
+* station comes free.  We walk the voters once in arrival order and
+* keep the stations in a min-heap keyed on the time they come free,
+* which costs O(N log S) rather than a walk through the whole day.
+*
+* Ties between stations that come free at the same second are broken
+* by the order in which they were last taken, which is the order in
+* which the event engine frees them, so the station numbers match
+* those of 'RunSimulationPct2'.
+* 
+* Parameters:
+*    stations_count - number of stations to use in this simulation
+**/
+void OnePct::RunSimulationPctFifo(int stations_count) {
+  const int *arrival = voter_arrival_.data() + voters_first_;
+  const int *duration = voter_duration_.data() + voters_first_;
+  greater<StationFree> later;
+
+  // in order of station number, all free at the start, is a heap
+  stations_free_.clear();
+  for (int i = 0; i < stations_count; ++i) {
+    stations_free_.push_back(StationFree(0, i - stations_count, i));
+  }
+
+  for (int voter = 0; voter < voters_count_; ++voter) {
+    pop_heap(stations_free_.begin(), stations_free_.end(), later);
+    StationFree station = stations_free_.back();
+    stations_free_.pop_back();
+
+    int start_time = std::get<0>(station);
+    if (arrival[voter] > start_time) {
+      start_time = arrival[voter];
     }
-    ++second;
-  } // while (!done) {
+    wait_statistics_.Add(start_time - arrival[voter], arrival[voter]);
+    start_checksum_ = (start_checksum_
+                       ^ ((static_cast<uint64_t>(start_time) << 20)
+                          | static_cast<uint64_t>(std::get<2>(station))))
+                    * kChecksumPrime;
+    int leave_time = start_time + duration[voter];
+    stations_free_.push_back(StationFree(leave_time, voter,
+                                         std::get<2>(station)));
+    push_heap(stations_free_.begin(), stations_free_.end(), later);
+  }
+} // void OnePct::RunSimulationPctFifo(int stations_count)
 
-} // void Simulation::RunSimulationPct2()
+/****************************************************************
+* Function 'SimulateStations'
+*
+* Runs the queue engine chosen in the configuration for the current
+* voters and the given number of stations.  The 'verify' engine runs
+* both engines and records the first time they disagree about any
+* voter's station or start, for 'GetEngineMismatch'.  This may be run by
+* a worker thread, so stopping the program is left to whoever runs the
+* precinct.  Both engines start the voters in order of arrival, so they
+* agree if their statistics and their checksums of the voters' starts
+* and stations agree.
+* 
+* Parameters:
+*    config - The configuration
+*    stations_count - number of stations to use in this simulation
+**/
+void OnePct::SimulateStations(const Configuration& config,
+                              int stations_count) {
+  wait_statistics_.Reset(config.wait_time_minutes_that_is_too_long_);
+  start_checksum_ = kChecksumBasis;
+  if ("fifo" == config.engine_) {
+    this->RunSimulationPctFifo(stations_count);
+    return;
+  }
+
+  this->RunSimulationPct2(stations_count);
+  if ("verify" != config.engine_) {
+    return;
+  }
+
+  // the checksum and a few numbers are all that need saving
+  uint64_t event_checksum = start_checksum_;
+  LONG event_count = wait_statistics_.GetCount();
+  double event_mean = wait_statistics_.GetMeanSeconds();
+  double event_deviations = wait_statistics_.GetSumOfSquaredDeviations();
+  wait_statistics_.Reset(config.wait_time_minutes_that_is_too_long_);
+  start_checksum_ = kChecksumBasis;
+  this->RunSimulationPctFifo(stations_count);
+
+  bool same = (event_checksum == start_checksum_) &&
+              (event_count == wait_statistics_.GetCount()) &&
+              (event_mean == wait_statistics_.GetMeanSeconds()) &&
+              (event_deviations
+               == wait_statistics_.GetSumOfSquaredDeviations());
+  if (!same && engine_mismatch_.empty()) {
+    engine_mismatch_ = kTag + "ENGINE MISMATCH pct "
+                     + Utils::Format(pct_number_, 4) + " stations "
+                     + Utils::Format(stations_count, 4) + "\n";
+  }
+} // void OnePct::SimulateStations(const Configuration& config, int ...)
 
 /****************************************************************
 **/
 string OnePct::ToString() {
-  string s = "";
+  FormatBuffer s;
 
-  s += Utils::Format(pct_number_, 4);
-  s += " " + Utils::Format(pct_name_, 25, "left");
-  s += Utils::Format(pct_turnout_, 8, 2);
-  s += Utils::Format(pct_num_voters_, 8);
-  s += Utils::Format(pct_expected_voters_, 8);
-  s += Utils::Format(pct_expected_per_hour_, 8);
-  s += Utils::Format(pct_stations_, 3);
-  s += Utils::Format(pct_minority_, 8, 2);
+  s.Append(pct_number_, 4);
+  s.Append(" ").Append(pct_name_, 25, "left");
+  // the turnout has always come out justified left, the shared stream
+  // 'Format' used being left set to 'left' by the name before it
+  s.Append(Utils::Format(pct_turnout_, 0, 2), 8, "left");
+  s.Append(pct_num_voters_, 8);
+  s.Append(pct_expected_voters_, 8);
+  s.Append(pct_expected_per_hour_, 8);
+  s.Append(pct_stations_, 3);
+  s.Append(pct_minority_, 8, 2);
 
-  s += " HH ";
+  s.Append(" HH ");
   for (auto iter = stations_to_histo_.begin();
        iter != stations_to_histo_.end(); ++iter) {
-    s += Utils::Format(*iter, 4);
+    s.Append(*iter, 4);
   }
-  s += " HH";
+  s.Append(" HH");
 
-  return s;
+  return s.GetString();
 } // string OnePct::ToString()
 
 /****************************************************************
+* Lists the M/G/c approximation of the wait for each hour at one
+* station count, then the mean wait over the iterations as simulated
+* and as adjusted by the control variate, each with its standard
+* error, and the coefficient of the adjustment.  For antithetic
+* iterations the regression is over the pairs.
+**/
+string OnePct::ToStringControl(int stations_count,
+                               const StationCountResult& result) const {
+  string s = "";
+  int offset = 6;
+
+  for (UINT hour = 0; hour < mgc_wait_seconds_.size(); ++hour) {
+    s += kTag + "MGC " + Utils::Format(pct_number_, 4)
+       + Utils::Format(stations_count, 4) + " stations "
+       + Utils::Format(static_cast<int>(offset + hour), 2) + "-"
+       + Utils::Format(static_cast<int>(offset + hour + 1), 2)
+       + " utilization " + Utils::Format(mgc_utilization_[hour], 6, 3)
+       + " approx wait (mins) "
+       + Utils::Format(mgc_wait_seconds_[hour] / 60.0, 8, 2) + "\n";
+  }
+
+  const ControlVariate& control = result.control;
+  double plain_variance = 0.0;
+  if (control.count > 1) {
+    plain_variance = control.wait_squares
+                   / static_cast<double>(control.count - 1)
+                   / static_cast<double>(control.count);
+  }
+  s += kTag + "CONTROL " + Utils::Format(pct_number_, 4)
+     + Utils::Format(stations_count, 4) + " stations "
+     + Utils::Format(result.iterations, 5) + " iterations, wait (mins) "
+     + Utils::Format(control.wait_mean, 8, 2) + " std error "
+     + Utils::Format(sqrt(plain_variance), 8, 3) + " adjusted "
+     + Utils::Format(control.GetAdjustedMean(), 8, 2) + " std error "
+     + Utils::Format(sqrt(control.GetAdjustedVarianceOfMean()), 8, 3)
+     + " coefficient " + Utils::Format(control.GetCoefficient(), 8, 3)
+     + "\n";
+
+  return s;
+} // string OnePct::ToStringControl(int stations_count, ...)
+
+/****************************************************************
+* Lists the percentiles of the waits for one station count, over all
+* its iterations, for the whole day and then by hour of arrival.  The
+* hours are labeled as in the configuration's 'ToString'.
 **/
-string OnePct::ToStringVoterMap(string label,
-                                multimap<int, OneVoter> themap) {
+string OnePct::ToStringPercentiles(int stations_count,
+                                   const StationCountResult& result) const {
   string s = "";
+  int offset = 6;
 
-  s += "\n" + label + " WITH " + Utils::Format((int)themap.size(), 6)
+  WaitSketch day;
+  for (UINT hour = 0; hour < result.hour_sketches.size(); ++hour) {
+    day.Merge(result.hour_sketches.at(hour));
+  }
+
+  for (int hour = -1; hour < static_cast<int>(result.hour_sketches.size());
+       ++hour) {
+    const WaitSketch& sketch = (hour < 0) ? day
+                                          : result.hour_sketches.at(hour);
+    string label = "  all";
+    if (hour >= 0) {
+      label = Utils::Format(offset + hour, 2) + "-"
+            + Utils::Format(offset + hour + 1, 2);
+    }
+    s += kTag + "PCTILE " + Utils::Format(pct_number_, 4)
+       + Utils::Format(stations_count, 4) + " stations " + label
+       + " voters " + Utils::Format(sketch.GetCount(), 7)
+       + " wait (mins) P50 "
+       + Utils::Format(sketch.GetPercentile(0.50) / 60.0, 8, 2)
+       + " P90 " + Utils::Format(sketch.GetPercentile(0.90) / 60.0, 8, 2)
+       + " P99 " + Utils::Format(sketch.GetPercentile(0.99) / 60.0, 8, 2)
+       + " max " + Utils::Format(sketch.GetMax() / 60.0, 8, 2) + "\n";
+  }
+
+  return s;
+} // string OnePct::ToStringPercentiles(int stations_count, ...)
+
+/****************************************************************
+* Reports how much the sampling narrowed the estimate for one station
+* count: the standard error of the mean of the measure as sampled,
+* the standard error plain sampling would have had over the same
+* number of iterations, and the ratio of their variances, which is how
+* many times as many plain iterations would be needed for the same
+* precision.  The plain figure comes from the baseline iterations if
+* they were run.  Otherwise antithetic iterations, each of which on
+* its own is a plain iteration, give it from their spread one by one;
+* stratified iterations cannot, and show 'n/a'.
+**/
+string OnePct::ToStringSampling(const Configuration& config,
+                                int stations_count,
+                                const StationCountResult& result) const {
+  string s = "";
+
+  double sampled_variance = result.units.GetVarianceOfMean();
+  double plain_variance = -1.0;
+  string plain_source = "";
+  if (result.baseline.count > 0) {
+    plain_variance = result.baseline.GetVarianceOfMean();
+    plain_source = " (baseline)";
+  } else if ("antithetic" == config.sampling_) {
+    plain_variance = result.measure.GetVarianceOfMean();
+    plain_source = " (estimated)";
+  }
+
+  s += kTag + "SAMPLING " + Utils::Format(pct_number_, 4)
+     + Utils::Format(stations_count, 4) + " stations "
+     + Utils::Format(config.sampling_, 10, "left")
+     + Utils::Format(result.iterations, 5) + " iterations, "
+     + config.ci_measure_ + " mean "
+     + Utils::Format(result.units.mean, 10, 4)
+     + " std error " + Utils::Format(sqrt(sampled_variance), 10, 5);
+  if (plain_variance < 0.0) {
+    s += " plain n/a\n";
+    return s;
+  }
+  s += " plain " + Utils::Format(sqrt(plain_variance), 10, 5) + plain_source;
+  if (sampled_variance > 0.0) {
+    s += " variance reduction "
+       + Utils::Format(plain_variance / sampled_variance, 8, 2);
+  } else {
+    s += " variance reduction n/a";
+  }
+  s += "\n";
+
+  return s;
+} // string OnePct::ToStringSampling(const Configuration& config, ...)
+
+/****************************************************************
+* Lists the voters of the current population.  Where they voted is
+* not kept, so only their arrivals and durations mean anything.
+**/
+string OnePct::ToStringVoters(string label) const {
+  string s = "";
+
+  s += "\n" + label + " WITH " + Utils::Format(voters_count_, 6)
      + " ENTRIES\n";
   s += OneVoter::ToStringHeader() + "\n";
-  for (auto iter = themap.begin(); iter != themap.end(); ++iter) {
-    s += (iter->second).ToString() + "\n";
+  for (int voter = 0; voter < voters_count_; ++voter) {
+    OneVoter one_voter(voter, voter_arrival_[voters_first_ + voter],
+                       voter_duration_[voters_first_ + voter]);
+    s += one_voter.ToString() + "\n";
   }
 
   return s;
-} // string OnePct::ToString()
+} // string OnePct::ToStringVoters(string label) const
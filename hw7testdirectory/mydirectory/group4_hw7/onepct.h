@@ -16,12 +16,19 @@
 #ifndef ONEPCT_H
 #define ONEPCT_H
 
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
+#include <functional>
 #include <map>
+#include <queue>
+#include <tuple>
 #include <set>
 #include <vector>
 
 #include "../Utilities/utils.h"
+#include "../Utilities/allocationcounter.h"
+#include "../Utilities/formatbuffer.h"
 #include "../Utilities/scanner.h"
 #include "../Utilities/scanline.h"
 
@@ -29,7 +36,11 @@ using namespace std;
 
 #include "configuration.h"
 #include "myrandom.h"
+#include "histogram.h"
 #include "onevoter.h"
+#include "pcttable.h"
+#include "waitsketch.h"
+#include "waitstatistics.h"
 
 static const double kDummyDouble = -88.88;
 static const int kDummyInt = -999;
@@ -47,19 +58,79 @@ public:
 /****************************************************************
  * Accessors and Mutators.
 **/
+  LONG GetAllocationsReserving() const;
+  LONG GetAllocationsSimulating() const;
+  string GetEngineMismatch() const;
+  LONG GetEstimatedCost(const Configuration& config) const;
   int GetExpectedVoters() const;
+  int GetIterationsRun() const;
+  int GetMaxStationCount(const Configuration& config) const;
+  int GetMinStationCount(const Configuration& config) const;
   int GetPctNumber() const;
+  int GetPopulationSize(const Configuration& config) const;
 
 /****************************************************************
  * General functions.
 **/
   void ReadData(Scanner& infile);
-  void RunSimulationPct(const Configuration& config, MyRandom& random, ofstream& out_stream);
+  void ReadData(const PctTable& table, int row);
+  void RunFluidPct(const Configuration& config, ostream& out_stream);
+  void RunSimulationPct(const Configuration& config, MyRandom& random, ostream& out_stream);
 
   string ToString();
-  string ToStringVoterMap(string label, multimap<int, OneVoter> themap);
+  string ToStringVoters(string label) const;
 
 private:
+  // the running mean and sum of squared deviations of a measure, by
+  // Welford's method
+  struct RunningMeasure {
+    int count = 0;
+    double mean = 0.0;
+    double squares = 0.0;
+
+    void Add(double measure);
+    double GetVarianceOfMean() const;
+  };
+
+  // the running means and co-moments of the mean wait and of a control
+  // variate whose mean is known to be zero, for the regression that
+  // adjusts the wait by the control
+  struct ControlVariate {
+    int count = 0;
+    double wait_mean = 0.0;
+    double control_mean = 0.0;
+    double wait_squares = 0.0;
+    double control_squares = 0.0;
+    double cross = 0.0;
+
+    void Add(double wait, double control);
+    double GetAdjustedMean() const;
+    double GetAdjustedVarianceOfMean() const;
+    double GetCoefficient() const;
+  };
+
+  // everything learned about one station count over its iterations
+  struct StationCountResult {
+    string report;
+    Histogram histogram;
+    vector<WaitSketch> hour_sketches;
+
+    // the iterations run and the measure the adaptive iterations watch,
+    // taken over single iterations, over the independent units of the
+    // estimate (antithetic pairs, or else single iterations), and over
+    // the plain baseline iterations if any
+    int iterations = 0;
+    RunningMeasure measure;
+    RunningMeasure units;
+    RunningMeasure baseline;
+    double pair_first = 0.0;
+
+    // the mean wait adjusted by the M/G/c control variate, if wanted
+    ControlVariate control;
+    double pair_first_wait = 0.0;
+    double pair_first_control = 0.0;
+  };
+
   int    pct_expected_voters_ = kDummyInt;
   int    pct_expected_per_hour_ = kDummyInt;
   double pct_minority_ = kDummyDouble;
@@ -71,22 +142,116 @@ private:
   double wait_dev_seconds_;
   double wait_mean_seconds_;
   set<int> stations_to_histo_;
+
+  // the mean and squared coefficient of variation of the measured
+  // service times, for the queueing approximations
+  double service_mean_seconds_ = 0.0;
+  double service_scv_ = 0.0;
+
+  // for the M/G/c control variate: for each hour the
+  // voters who arrived and their total service time in the current
+  // population, and the approximate wait, its slope with respect to the
+  // mean service time, and the utilization for the current station count
+  vector<int> hour_voters_;
+  vector<LONG> hour_service_seconds_;
+  vector<double> mgc_wait_seconds_;
+  vector<double> mgc_slope_;
+  vector<double> mgc_utilization_;
   vector<int> free_stations_;
-  multimap<int, OneVoter> voters_backup_;
-  multimap<int, OneVoter> voters_done_voting_;
-  multimap<int, OneVoter> voters_pending_;
-  multimap<int, OneVoter> voters_voting_;
+  vector<int> random_interarrivals_;
+  vector<int> random_service_times_;
+
+  // Voters are kept as parallel arrays, one entry per voter, in order of
+  // arrival; a voter's sequence number is its subscript.  With shared
+  // populations every iteration's voters are kept one after another and
+  // population 'i' is the voters from 'population_first_[i]' up to
+  // 'population_first_[i + 1]'.
+  vector<int> population_first_;
+  vector<int> voter_arrival_;
+  vector<int> voter_duration_;
+  vector<uint64_t> voter_sort_keys_;
+
+  // the population being simulated
+  int voters_first_ = 0;
+  int voters_count_ = 0;
+
+  // voters at a station, as a heap of (leave time, order started,
+  // station number)
+  typedef tuple<int, int, int> VoterLeaving;
+  vector<VoterLeaving> voters_voting_;
+
+  // stations for the fifo engine, as a heap of (time free, order taken,
+  // station number)
+  typedef tuple<int, int, int> StationFree;
+  vector<StationFree> stations_free_;
+
+  // the waits of the last simulation, taken as each voter started, and
+  // a checksum of every voter's start and station for 'verify'; the
+  // voters themselves are not kept once they start
+  WaitStatistics wait_statistics_;
+  uint64_t start_checksum_ = 0;
+
+  // the report line being built, kept from line to line so that
+  // building one allocates nothing once the buffer is long enough
+  FormatBuffer line_;
+
+  // heap allocations made on the way into 'RunSimulationPct' and in
+  // creating, simulating, and taking the statistics of each iteration
+  // since, all but the report line, which grows with every iteration
+  LONG allocations_reserving_ = 0;
+  LONG allocations_simulating_ = 0;
+  int iterations_run_ = 0;
+
+  // the first disagreement the 'verify' engine found, or empty;
+  // it is left to whoever runs the precinct to report, since that
+  // may be a worker thread
+  string engine_mismatch_ = "";
 
 /****************************************************************
  * General private functions.
 **/
-  void CreateVoters(const Configuration& config, MyRandom& random,
-                    ofstream& out_stream);
-  int DoStatistics(int iteration, const Configuration& config, int station_count,
-                   map<int, int>& map_for_histo, ofstream& out_stream);
+  void ClearPopulations();
+  void CreateVoters(const Configuration& config, const string& sampling,
+                    MyRandom& random, ostream& out_stream);
+  int DoStatistics(int iteration, int station_count,
+                   StationCountResult& result);
+  void OutputStationCount(const Configuration& config, int stations_count,
+                          const StationCountResult& result,
+                          ostream& out_stream);
                     
   void ComputeMeanAndDev();
+  void ComputeMgcApproximation(const Configuration& config, int stations);
+  void ComputeServiceMoments(const Configuration& config);
+  int DoFluidStatistics(const Configuration& config, int station_count,
+                        string& outstring) const;
+  double GetControl();
+  double GetHalfWidth(const RunningMeasure& measure) const;
+  void GetIterationLimits(const Configuration& config, int& min_iterations,
+                          int& max_iterations) const;
+  double GetMeasure(const Configuration& config, int number_too_long) const;
+  double GetStudentT(int degrees) const;
+  bool EvaluateStationCount(const Configuration& config, MyRandom& random,
+                   int stations_count, StationCountResult& result,
+                   ostream& out_stream);
+  double GetExpectedTooLong(const Configuration& config, int stations) const;
+  double GetFluidMaxWait(const Configuration& config, int stations,
+                         int& worst_hour) const;
+  int GetVotersThisHour(const Configuration& config, int hour) const;
+  void ReserveBuffers(const Configuration& config, MyRandom& random);
   void RunSimulationPct2(int stations);
+  void RunSimulationPctFifo(int stations);
+  bool ScreenStationCounts(const Configuration& config,
+                           int& min_station_count, int& max_station_count,
+                           ostream& out_stream) const;
+  void SelectPopulation(int which);
+  void SimulateStations(const Configuration& config, int stations_count);
+  void SortPopulation(int first);
+  string ToStringControl(int stations_count,
+                         const StationCountResult& result) const;
+  string ToStringPercentiles(int stations_count,
+                             const StationCountResult& result) const;
+  string ToStringSampling(const Configuration& config, int stations_count,
+                          const StationCountResult& result) const;
 
 };
 
@@ -132,7 +132,7 @@ string OneVoter::ConvertTime(int time_in_seconds) const {
   //------REVISED CODE ---------------
   
   minutes = time_in_seconds / 60;
-  second = time_in_seconds;
+  seconds = time_in_seconds;
   
   //----------------------------------
 
@@ -0,0 +1,91 @@
+/****************************************************************
+ * Converter from the precinct text file to the binary precinct file.
+ * Reads the text, writes the binary columns, then maps the new file
+ * and checks every field against the text before saying it is done.
+ *
+ * Usage: pctconvert pcttextfile pctbinaryfile
+ *
+ * Author/copyright:  Duncan Buell. All rights reserved.
+ * Used with permission and modified by: Group 4
+ *                                       Erik Akeyson
+ *                                       Matthew Clapp
+ *                                       Harrison Goodman
+ *                                       Andy Michels
+ *                                       Steve Smero
+ * Date: 1 December 2016
+ *
+**/
+#include <chrono>
+#include <iostream>
+#include <string>
+
+#include "../Utilities/utils.h"
+#include "../Utilities/scanner.h"
+
+using namespace std;
+
+#include "pcttable.h"
+
+static const string kTag = "PCTCONVERT: ";
+
+/****************************************************************
+ * Returns:
+ *   true if row 'row' of the two tables is the same in every field
+**/
+static bool SameRow(const PctTable& text, const PctTable& binary, int row) {
+  bool same = (text.GetNumber(row) == binary.GetNumber(row))
+           && (text.GetName(row) == binary.GetName(row))
+           && (text.GetTurnout(row) == binary.GetTurnout(row))
+           && (text.GetNumVoters(row) == binary.GetNumVoters(row))
+           && (text.GetExpectedVoters(row) == binary.GetExpectedVoters(row))
+           && (text.GetExpectedPerHour(row) == binary.GetExpectedPerHour(row))
+           && (text.GetStations(row) == binary.GetStations(row))
+           && (text.GetMinority(row) == binary.GetMinority(row));
+  for (int which = 0; which < PctTable::kHistoCount; ++which) {
+    same = same && (text.GetHistoStations(row, which)
+                    == binary.GetHistoStations(row, which));
+  }
+  return same;
+}
+
+int main(int argc, char *argv[]) {
+  Utils::CheckArgs(2, argc, argv, "pcttextfile pctbinaryfile");
+  string text_filename = static_cast<string>(argv[1]);
+  string binary_filename = static_cast<string>(argv[2]);
+
+  chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+  Scanner text_stream;
+  text_stream.OpenFile(text_filename);
+  PctTable text_table;
+  text_table.ReadText(text_stream);
+  text_stream.Close();
+  chrono::duration<double> text_time = chrono::steady_clock::now() - begin;
+
+  if (!text_table.Write(binary_filename)) {
+    return 1;
+  }
+
+  begin = chrono::steady_clock::now();
+  PctTable binary_table;
+  binary_table.Map(binary_filename);
+  chrono::duration<double> map_time = chrono::steady_clock::now() - begin;
+
+  if (binary_table.GetCount() != text_table.GetCount()) {
+    cout << kTag << "MISMATCH in the precinct count" << endl;
+    return 1;
+  }
+  for (int row = 0; row < text_table.GetCount(); ++row) {
+    if (!SameRow(text_table, binary_table, row)) {
+      cout << kTag << "MISMATCH in row " << row << endl;
+      return 1;
+    }
+  }
+
+  cout << binary_table.ToString();
+  cout << kTag << "text read " << Utils::Format(1000.0 * text_time.count(),
+                                                10, 3) << " ms" << endl;
+  cout << kTag << "table map " << Utils::Format(1000.0 * map_time.count(),
+                                                10, 3) << " ms" << endl;
+
+  return 0;
+}
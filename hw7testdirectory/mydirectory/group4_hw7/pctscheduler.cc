@@ -0,0 +1,181 @@
+#include "pctscheduler.h"
+/****************************************************************
+ * Implementation for the 'PctScheduler' class.
+ * Precincts differ in cost by orders of magnitude, from a few dozen
+ * voters to many thousands, so handing each thread a fixed share
+ * leaves threads idle behind one or two large precincts.
+ *
+ * Tasks are sorted by estimated cost, largest first, and dealt in
+ * turn onto the workers' deques, so every deque starts with its
+ * largest task at the front.  A worker takes from the front of its
+ * own deque.  When that is empty it steals from the back of another
+ * worker's deque, where the smallest tasks are, so the owners keep
+ * the big tasks and the thieves fill in the gaps at the end.
+ *
+ * Author/copyright:  Duncan Buell. All rights reserved.
+ * Used with permission and modified by: Group 4
+ *                                       Erik Akeyson
+ *                                       Matthew Clapp
+ *                                       Harrison Goodman
+ *                                       Andy Michels
+ *                                       Steve Smero
+ * Date: 1 December 2016
+**/
+
+static const string kTag = "SCHED: ";
+
+/****************************************************************
+* Constructor.
+**/
+PctScheduler::PctScheduler(int thread_count)
+  : thread_count_(thread_count), workers_(thread_count) {
+}
+
+/****************************************************************
+* Destructor.
+**/
+PctScheduler::~PctScheduler() {
+  this->Wait();
+}
+
+/****************************************************************
+* General functions.
+**/
+/****************************************************************
+* Function 'Start'
+*
+* Deals out the tasks and starts the worker threads.  Task 'i' has
+* estimated cost 'costs[i]'; the call 'task(i)' does the work.  Tasks
+* of equal cost are dealt in task number order.
+*
+* Parameters:
+*    costs - the estimated cost of each task
+*    task - the function that runs one task
+**/
+void PctScheduler::Start(const vector<LONG>& costs, function<void(int)> task) {
+  vector<int> by_cost;
+  for (int which = 0; which < static_cast<int>(costs.size()); ++which) {
+    by_cost.push_back(which);
+  }
+  stable_sort(by_cost.begin(), by_cost.end(),
+              [&costs](int a, int b) { return costs.at(a) > costs.at(b); });
+
+  for (UINT sub = 0; sub < by_cost.size(); ++sub) {
+    workers_.at(sub % thread_count_).tasks.push_back(by_cost.at(sub));
+  }
+
+  task_ = task;
+  start_time_ = chrono::steady_clock::now();
+  for (int worker = 0; worker < thread_count_; ++worker) {
+    threads_.push_back(thread(&PctScheduler::WorkerLoop, this, worker));
+  }
+}
+
+/****************************************************************
+* Function 'Wait'
+*
+* Waits for all the tasks to finish.
+**/
+void PctScheduler::Wait() {
+  if (threads_.empty()) {
+    return;
+  }
+  for (auto iter = threads_.begin(); iter != threads_.end(); ++iter) {
+    iter->join();
+  }
+  threads_.clear();
+
+  chrono::duration<double> wall = chrono::steady_clock::now() - start_time_;
+  wall_seconds_ = wall.count();
+}
+
+/****************************************************************
+* Function 'TakeTask'
+*
+* Gets the next task for a worker, from the front of its own deque
+* or else from the back of the first other deque that has any.
+*
+* Parameters:
+*    worker - the worker wanting a task
+*    task - set to the task number
+*    stolen - set to true if the task came from another worker
+*
+* Returns:
+*    false if there is no task left anywhere
+**/
+bool PctScheduler::TakeTask(int worker, int& task, bool& stolen) {
+  {
+    Worker& mine = workers_.at(worker);
+    lock_guard<mutex> guard(mine.lock);
+    if (!mine.tasks.empty()) {
+      task = mine.tasks.front();
+      mine.tasks.pop_front();
+      stolen = false;
+      return true;
+    }
+  }
+
+  for (int offset = 1; offset < thread_count_; ++offset) {
+    Worker& victim = workers_.at((worker + offset) % thread_count_);
+    lock_guard<mutex> guard(victim.lock);
+    if (!victim.tasks.empty()) {
+      task = victim.tasks.back();
+      victim.tasks.pop_back();
+      stolen = true;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/****************************************************************
+* Function 'WorkerLoop'
+*
+* Runs tasks until there are none left, timing each one.  Tasks are
+* never added once started, so an empty sweep means we are done.
+*
+* Parameters:
+*    worker - the number of this worker
+**/
+void PctScheduler::WorkerLoop(int worker) {
+  Worker& mine = workers_.at(worker);
+  int task = 0;
+  bool stolen = false;
+  while (this->TakeTask(worker, task, stolen)) {
+    chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+    task_(task);
+    chrono::duration<double> busy = chrono::steady_clock::now() - begin;
+
+    lock_guard<mutex> guard(mine.lock);
+    mine.busy_seconds += busy.count();
+    ++mine.tasks_run;
+    if (stolen) {
+      ++mine.tasks_stolen;
+    }
+  }
+}
+
+/****************************************************************
+* Usual 'ToString', here reporting how busy each worker was over
+* the wall clock time of the whole run.
+**/
+string PctScheduler::ToStringBusy() const {
+  string s = "";
+
+  for (int worker = 0; worker < thread_count_; ++worker) {
+    const Worker& this_worker = workers_.at(worker);
+    double busy_pct = 0.0;
+    if (wall_seconds_ > 0.0) {
+      busy_pct = 100.0 * this_worker.busy_seconds / wall_seconds_;
+    }
+    s += kTag + "worker " + Utils::Format(worker, 3)
+       + " tasks " + Utils::Format(this_worker.tasks_run, 6)
+       + " stolen " + Utils::Format(this_worker.tasks_stolen, 6)
+       + " busy " + Utils::Format(this_worker.busy_seconds, 10, 3) + " s "
+       + Utils::Format(busy_pct, 6, 2) + "%\n";
+  }
+  s += kTag + "wall " + Utils::Format(wall_seconds_, 10, 3) + " s\n";
+
+  return s;
+}
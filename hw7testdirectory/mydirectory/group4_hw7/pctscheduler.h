@@ -0,0 +1,74 @@
+/****************************************************************
+ * Header for the 'PctScheduler' class.
+ * A pool of worker threads, each with its own deque of tasks, that
+ * steal from one another when their own deque runs dry.
+ *
+ * Author/copyright:  Duncan Buell
+ * Used with permission and modified by: Group 4
+ *                                       Erik Akeyson
+ *                                       Matthew Clapp
+ *                                       Harrison Goodman
+ *                                       Andy Michels
+ *                                       Steve Smero
+ * Date: 1 December 2016
+ *
+**/
+
+#ifndef PCTSCHEDULER_H
+#define PCTSCHEDULER_H
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../Utilities/utils.h"
+
+using namespace std;
+
+class PctScheduler {
+public:
+/****************************************************************
+ * Constructors and destructors for the class.
+**/
+ PctScheduler(int thread_count);
+ virtual ~PctScheduler();
+
+/****************************************************************
+ * General functions.
+**/
+ void Start(const vector<LONG>& costs, function<void(int)> task);
+ void Wait();
+
+ string ToStringBusy() const;
+
+private:
+/****************************************************************
+ * One worker: its deque of task numbers and what it has done.
+**/
+ struct Worker {
+   mutex lock;
+   deque<int> tasks;
+   double busy_seconds = 0.0;
+   int tasks_run = 0;
+   int tasks_stolen = 0;
+ };
+
+ int thread_count_;
+ double wall_seconds_ = 0.0;
+ chrono::steady_clock::time_point start_time_;
+ function<void(int)> task_;
+ vector<thread> threads_;
+ vector<Worker> workers_;
+
+/****************************************************************
+ * General private functions.
+**/
+ bool TakeTask(int worker, int& task, bool& stolen);
+ void WorkerLoop(int worker);
+};
+
+#endif // PCTSCHEDULER_H
@@ -0,0 +1,386 @@
+#include "pcttable.h"
+/****************************************************************
+ * Implementation for the 'PctTable' class.
+ * Parsing the precinct text file token by token takes seconds for a
+ * nationwide table of hundreds of thousands of precincts.  The same
+ * data kept as a column for each field, in a file that is mapped
+ * and used where it lies, loads in milliseconds.  'pctconvert' makes
+ * such a file from a text file, and 'main' reads either kind.
+ *
+ * Author/copyright:  Duncan Buell. All rights reserved.
+ * Used with permission and modified by: Group 4
+ *                                       Erik Akeyson
+ *                                       Matthew Clapp
+ *                                       Harrison Goodman
+ *                                       Andy Michels
+ *                                       Steve Smero
+ * Date: 1 December 2016
+**/
+
+static const string kTag = "PCTTABLE: ";
+
+/****************************************************************
+ * Layout of the binary precinct file: this header, then the columns
+ *   number, name offset, turnout, voters, expected voters, expected
+ *   per hour, stations, minority, histogram stations, names
+ * each padded to a multiple of eight bytes so the next one is aligned.
+ * The name offsets are 'count + 1' offsets into the names, and there
+ * are 'kHistoCount' histogram stations to a precinct.  The checksum
+ * is over everything after the header.
+**/
+static const char kPctTableMagic[8] = {'P', 'C', 'T', 'T',
+                                       'A', 'B', 'L', 'E'};
+static const uint32_t kPctTableVersion = 1;
+
+struct PctTableHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t count;
+  uint32_t name_bytes;
+  uint32_t checksum;
+};
+
+// where each column starts in the file, and the size of the file
+struct PctTableLayout {
+  size_t number;
+  size_t name_offset;
+  size_t turnout;
+  size_t num_voters;
+  size_t expected_voters;
+  size_t expected_per_hour;
+  size_t stations;
+  size_t minority;
+  size_t histo_stations;
+  size_t names;
+  size_t size;
+};
+
+static size_t Padded(size_t bytes) {
+  return (bytes + 7) & ~static_cast<size_t>(7);
+}
+
+static PctTableLayout GetLayout(uint32_t count, uint32_t name_bytes) {
+  size_t ints = Padded(count * sizeof(int32_t));
+  size_t doubles = Padded(count * sizeof(double));
+
+  PctTableLayout layout;
+  layout.number = sizeof(PctTableHeader);
+  layout.name_offset = layout.number + ints;
+  layout.turnout = layout.name_offset
+                 + Padded((static_cast<size_t>(count) + 1) * sizeof(uint32_t));
+  layout.num_voters = layout.turnout + doubles;
+  layout.expected_voters = layout.num_voters + ints;
+  layout.expected_per_hour = layout.expected_voters + ints;
+  layout.stations = layout.expected_per_hour + ints;
+  layout.minority = layout.stations + ints;
+  layout.histo_stations = layout.minority + doubles;
+  layout.names = layout.histo_stations
+               + Padded(count * PctTable::kHistoCount * sizeof(int32_t));
+  layout.size = layout.names + Padded(name_bytes);
+  return layout;
+}
+
+/****************************************************************
+ * FNV-1a a word at a time, as for the service times file.
+**/
+static uint32_t PctTableChecksum(const char *body, size_t bytes) {
+  const uint32_t *words = reinterpret_cast<const uint32_t *>(body);
+  uint32_t hash = 2166136261u;
+  for (size_t sub = 0; sub < bytes / sizeof(uint32_t); ++sub) {
+    hash = (hash ^ words[sub]) * 16777619u;
+  }
+  return hash;
+}
+
+/****************************************************************
+* Constructor.
+**/
+PctTable::PctTable() {
+}
+
+/****************************************************************
+* Destructor.
+**/
+PctTable::~PctTable() {
+}
+
+/****************************************************************
+* Accessors and mutators.
+**/
+/****************************************************************
+**/
+int PctTable::GetCount() const {
+  return count_;
+}
+
+/****************************************************************
+**/
+int PctTable::GetExpectedPerHour(int row) const {
+  return expected_per_hour_[row];
+}
+
+/****************************************************************
+**/
+int PctTable::GetExpectedVoters(int row) const {
+  return expected_voters_[row];
+}
+
+/****************************************************************
+* Returns the 'which'th of the station counts to histogram.
+**/
+int PctTable::GetHistoStations(int row, int which) const {
+  return histo_stations_[row * kHistoCount + which];
+}
+
+/****************************************************************
+**/
+double PctTable::GetMinority(int row) const {
+  return minority_[row];
+}
+
+/****************************************************************
+**/
+string PctTable::GetName(int row) const {
+  return string(names_ + name_offset_[row],
+                name_offset_[row + 1] - name_offset_[row]);
+}
+
+/****************************************************************
+**/
+int PctTable::GetNumber(int row) const {
+  return number_[row];
+}
+
+/****************************************************************
+**/
+int PctTable::GetNumVoters(int row) const {
+  return num_voters_[row];
+}
+
+/****************************************************************
+**/
+int PctTable::GetStations(int row) const {
+  return stations_[row];
+}
+
+/****************************************************************
+**/
+double PctTable::GetTurnout(int row) const {
+  return turnout_[row];
+}
+
+/****************************************************************
+* General functions.
+**/
+/****************************************************************
+* Function 'IsTableFile'
+*
+* Parameters:
+*    filename - the file to look at
+*
+* Returns:
+*    true if the file starts as a binary precinct file does
+**/
+bool PctTable::IsTableFile(const string& filename) {
+  char magic[sizeof(kPctTableMagic)];
+  ifstream table_stream(filename, ios::in | ios::binary);
+  if (!table_stream.read(magic, sizeof(magic))) {
+    return false;
+  }
+  return 0 == memcmp(magic, kPctTableMagic, sizeof(kPctTableMagic));
+}
+
+/****************************************************************
+* Function 'Map'
+*
+* Maps a binary precinct file and points the columns into it.  A file
+* that cannot be mapped or fails its checks stops the program, since
+* there is nothing to simulate without it.
+*
+* Parameters:
+*    filename - the binary precinct file
+**/
+void PctTable::Map(const string& filename) {
+  if (!mapped_.Open(filename)) {
+    cout << kTag << "cannot map '" << filename << "'" << endl;
+    exit(1);
+  }
+
+  bool good = mapped_.GetSize() >= sizeof(PctTableHeader);
+  const PctTableHeader *header =
+      reinterpret_cast<const PctTableHeader *>(mapped_.GetData());
+  if (good) {
+    good = (0 == memcmp(header->magic, kPctTableMagic,
+                        sizeof(kPctTableMagic)))
+        && (kPctTableVersion == header->version)
+        && (mapped_.GetSize() == GetLayout(header->count,
+                                           header->name_bytes).size);
+  }
+  if (good) {
+    good = PctTableChecksum(mapped_.GetData() + sizeof(PctTableHeader),
+                            mapped_.GetSize() - sizeof(PctTableHeader))
+        == header->checksum;
+  }
+  if (good) {
+    this->PointAtColumns(mapped_.GetData(), header->count,
+                         header->name_bytes);
+    good = 0 == name_offset_[0];
+    for (int row = 0; good && (row < count_); ++row) {
+      good = name_offset_[row] <= name_offset_[row + 1];
+    }
+    good = good && (name_offset_[count_] == header->name_bytes);
+  }
+  if (!good) {
+    cout << kTag << "'" << filename << "' is not a good precinct file"
+         << endl;
+    exit(1);
+  }
+}
+
+/****************************************************************
+* Function 'PointAtColumns'
+*
+* Points the columns into a mapped file.
+*
+* Parameters:
+*    data - the start of the file
+*    count - the number of precincts
+*    name_bytes - the total length of the names
+**/
+void PctTable::PointAtColumns(const char *data, uint32_t count,
+                              uint32_t name_bytes) {
+  PctTableLayout layout = GetLayout(count, name_bytes);
+  count_ = static_cast<int>(count);
+  number_ = reinterpret_cast<const int32_t *>(data + layout.number);
+  name_offset_ = reinterpret_cast<const uint32_t *>(data
+                                                    + layout.name_offset);
+  turnout_ = reinterpret_cast<const double *>(data + layout.turnout);
+  num_voters_ = reinterpret_cast<const int32_t *>(data + layout.num_voters);
+  expected_voters_ = reinterpret_cast<const int32_t *>(
+      data + layout.expected_voters);
+  expected_per_hour_ = reinterpret_cast<const int32_t *>(
+      data + layout.expected_per_hour);
+  stations_ = reinterpret_cast<const int32_t *>(data + layout.stations);
+  minority_ = reinterpret_cast<const double *>(data + layout.minority);
+  histo_stations_ = reinterpret_cast<const int32_t *>(
+      data + layout.histo_stations);
+  names_ = data + layout.names;
+}
+
+/****************************************************************
+* Function 'ReadText'
+*
+* Reads a precinct text file, with the fields in the order that
+* 'OnePct::ReadData' reads them, into columns in memory.
+*
+* Parameters:
+*    infile - the precinct text file
+**/
+void PctTable::ReadText(Scanner& infile) {
+  name_offset_column_.assign(1, 0);
+  while (infile.HasNext()) {
+    number_column_.push_back(infile.NextInt());
+    names_column_ += infile.Next();
+    name_offset_column_.push_back(static_cast<uint32_t>(names_column_.size()));
+    turnout_column_.push_back(infile.NextDouble());
+    num_voters_column_.push_back(infile.NextInt());
+    expected_voters_column_.push_back(infile.NextInt());
+    expected_per_hour_column_.push_back(infile.NextInt());
+    stations_column_.push_back(infile.NextInt());
+    minority_column_.push_back(infile.NextDouble());
+    for (int which = 0; which < kHistoCount; ++which) {
+      histo_stations_column_.push_back(infile.NextInt());
+    }
+  }
+
+  count_ = static_cast<int>(number_column_.size());
+  number_ = number_column_.data();
+  name_offset_ = name_offset_column_.data();
+  turnout_ = turnout_column_.data();
+  num_voters_ = num_voters_column_.data();
+  expected_voters_ = expected_voters_column_.data();
+  expected_per_hour_ = expected_per_hour_column_.data();
+  stations_ = stations_column_.data();
+  minority_ = minority_column_.data();
+  histo_stations_ = histo_stations_column_.data();
+  names_ = names_column_.data();
+}
+
+/****************************************************************
+* Usual 'ToString'.
+**/
+string PctTable::ToString() const {
+  string s = "";
+
+  uint32_t name_bytes = (count_ > 0) ? name_offset_[count_] : 0;
+  s += kTag + "precincts " + Utils::Format(count_, 8)
+     + " name bytes " + Utils::Format(static_cast<int>(name_bytes), 10)
+     + " file bytes "
+     + Utils::Format(static_cast<LONG>(GetLayout(count_, name_bytes).size),
+                     12)
+     + "\n";
+
+  return s;
+}
+
+/****************************************************************
+* Function 'Write'
+*
+* Writes the binary precinct file.  As with the service times file,
+* it is written under a name of its own and renamed into place, so
+* that no run ever maps a half-written file.
+*
+* Parameters:
+*    filename - the binary precinct file
+*
+* Returns:
+*    true if the file was written
+**/
+bool PctTable::Write(const string& filename) const {
+  uint32_t count = static_cast<uint32_t>(count_);
+  uint32_t name_bytes = (count_ > 0) ? name_offset_[count_] : 0;
+  PctTableLayout layout = GetLayout(count, name_bytes);
+
+  vector<char> file(layout.size, 0);
+  memcpy(&file[layout.number], number_, count * sizeof(int32_t));
+  memcpy(&file[layout.name_offset], name_offset_,
+         (static_cast<size_t>(count) + 1) * sizeof(uint32_t));
+  memcpy(&file[layout.turnout], turnout_, count * sizeof(double));
+  memcpy(&file[layout.num_voters], num_voters_, count * sizeof(int32_t));
+  memcpy(&file[layout.expected_voters], expected_voters_,
+         count * sizeof(int32_t));
+  memcpy(&file[layout.expected_per_hour], expected_per_hour_,
+         count * sizeof(int32_t));
+  memcpy(&file[layout.stations], stations_, count * sizeof(int32_t));
+  memcpy(&file[layout.minority], minority_, count * sizeof(double));
+  memcpy(&file[layout.histo_stations], histo_stations_,
+         count * kHistoCount * sizeof(int32_t));
+  memcpy(&file[layout.names], names_, name_bytes);
+
+  PctTableHeader header;
+  memcpy(header.magic, kPctTableMagic, sizeof(kPctTableMagic));
+  header.version = kPctTableVersion;
+  header.count = count;
+  header.name_bytes = name_bytes;
+  header.checksum = PctTableChecksum(&file[sizeof(PctTableHeader)],
+                                     layout.size - sizeof(PctTableHeader));
+  memcpy(&file[0], &header, sizeof(header));
+
+  string temp_filename = filename + "."
+                       + Utils::Format(static_cast<int>(getpid())) + ".tmp";
+  ofstream table_stream(temp_filename, ios::out | ios::binary);
+  if (!table_stream) {
+    cout << kTag << "cannot write '" << filename << "'" << endl;
+    return false;
+  }
+  table_stream.write(file.data(), file.size());
+  table_stream.close();
+
+  if (!table_stream || (0 != rename(temp_filename.c_str(),
+                                    filename.c_str()))) {
+    cout << kTag << "cannot write '" << filename << "'" << endl;
+    remove(temp_filename.c_str());
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,106 @@
+/****************************************************************
+ * Header for the 'PctTable' class.
+ * The precinct data in a binary file of columns, one column to a
+ * field, that is mapped and read in place.
+ *
+ * Author/copyright:  Duncan Buell
+ * Used with permission and modified by: Group 4
+ *                                       Erik Akeyson
+ *                                       Matthew Clapp
+ *                                       Harrison Goodman
+ *                                       Andy Michels
+ *                                       Steve Smero
+ * Date: 1 December 2016
+ *
+**/
+
+#ifndef PCTTABLE_H
+#define PCTTABLE_H
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "../Utilities/utils.h"
+#include "../Utilities/mappedfile.h"
+#include "../Utilities/scanner.h"
+
+using namespace std;
+
+class PctTable {
+public:
+/****************************************************************
+ * Constructors and destructors for the class.
+**/
+ PctTable();
+ virtual ~PctTable();
+
+/****************************************************************
+ * Accessors and Mutators.
+**/
+ int GetCount() const;
+ int GetExpectedPerHour(int row) const;
+ int GetExpectedVoters(int row) const;
+ int GetHistoStations(int row, int which) const;
+ double GetMinority(int row) const;
+ string GetName(int row) const;
+ int GetNumber(int row) const;
+ int GetNumVoters(int row) const;
+ int GetStations(int row) const;
+ double GetTurnout(int row) const;
+
+/****************************************************************
+ * General functions.
+**/
+ static bool IsTableFile(const string& filename);
+
+ void Map(const string& filename);
+ void ReadText(Scanner& infile);
+ string ToString() const;
+ bool Write(const string& filename) const;
+
+ static const int kHistoCount = 3;
+
+private:
+ MappedFile mapped_;
+
+ // the columns, pointing into the mapped file or into the vectors
+ // below; 'name_offset_' has one more entry than there are rows so
+ // that the name of row 'i' ends where that of row 'i + 1' begins
+ int count_ = 0;
+ const int32_t *number_ = nullptr;
+ const uint32_t *name_offset_ = nullptr;
+ const double *turnout_ = nullptr;
+ const int32_t *num_voters_ = nullptr;
+ const int32_t *expected_voters_ = nullptr;
+ const int32_t *expected_per_hour_ = nullptr;
+ const int32_t *stations_ = nullptr;
+ const double *minority_ = nullptr;
+ const int32_t *histo_stations_ = nullptr;
+ const char *names_ = nullptr;
+
+ // the columns as read from a text file
+ vector<int32_t> number_column_;
+ vector<uint32_t> name_offset_column_;
+ vector<double> turnout_column_;
+ vector<int32_t> num_voters_column_;
+ vector<int32_t> expected_voters_column_;
+ vector<int32_t> expected_per_hour_column_;
+ vector<int32_t> stations_column_;
+ vector<double> minority_column_;
+ vector<int32_t> histo_stations_column_;
+ string names_column_;
+
+ void PointAtColumns(const char *data, uint32_t count,
+                     uint32_t name_bytes);
+
+ // no copies, since the columns may point into the mapped file
+ PctTable(const PctTable&);
+ PctTable& operator=(const PctTable&);
+};
+
+#endif // PCTTABLE_H
@@ -0,0 +1,267 @@
+#include "servicetable.h"
+/****************************************************************
+ * Implementation for the 'ServiceTable' class.
+ * The service time data file holds about thirteen thousand measured
+ * voting times but only a few hundred distinct values, all of which
+ * fit in 16 bits.  Drawing a time uniformly from the file is the same
+ * as drawing a distinct value with probability proportional to how
+ * often it occurs, which this class does in constant time with
+ * Walker's alias method over the distinct values.  The whole table is
+ * a few kilobytes and stays in the L1 cache.
+ *
+ * For stratified and antithetic draws we need the times in order of
+ * their quantile, which the alias table does not keep, so the class
+ * also holds the cumulative counts of the distinct values with a
+ * guide table (Chen and Asau) that points each of 1024 equal slices
+ * of probability at the first value that can lie in it.
+ *
+ * Author/copyright:  Duncan Buell. All rights reserved.
+ * Used with permission and modified by: Group 4
+ *                                       Erik Akeyson
+ *                                       Matthew Clapp
+ *                                       Harrison Goodman
+ *                                       Andy Michels
+ *                                       Steve Smero
+ * Date: 1 December 2016
+**/
+
+static const string kTag = "SERVICETABLE: ";
+
+/****************************************************************
+* Constructor.
+**/
+ServiceTable::ServiceTable() {
+}
+
+/****************************************************************
+* Destructor.
+**/
+ServiceTable::~ServiceTable() {
+}
+
+/****************************************************************
+* Accessors and mutators.
+**/
+/****************************************************************
+**/
+int ServiceTable::GetDistinctCount() const {
+  return static_cast<int>(distinct_value_.size());
+}
+
+/****************************************************************
+* General functions.
+**/
+/****************************************************************
+* Function 'Build'
+*
+* Builds the alias and quantile tables from the measured times, which
+* need not be sorted.  The alias table is built with Vose's method in
+* integer arithmetic: each column holds 'total' units, a distinct time
+* with 'c' occurrences brings c * (number of columns) units, and the
+* overflow of the big ones fills up the small ones.
+*
+* Parameters:
+*    service_times - the measured times, in seconds
+**/
+void ServiceTable::Build(const vector<int>& service_times) {
+  map<int, LONG> occurrences;
+  for (auto iter = service_times.begin(); iter != service_times.end();
+       ++iter) {
+    assert((*iter >= 0) && (*iter <= 0xFFFF));
+    ++occurrences[*iter];
+  }
+
+  total_count_ = static_cast<uint32_t>(service_times.size());
+  distinct_value_.clear();
+  cumulative_count_.clear();
+  uint32_t running_count = 0;
+  for (auto iter = occurrences.begin(); iter != occurrences.end(); ++iter) {
+    running_count += static_cast<uint32_t>(iter->second);
+    distinct_value_.push_back(static_cast<uint16_t>(iter->first));
+    cumulative_count_.push_back(running_count);
+  }
+
+  // guide_[g] is the first value whose cumulative count passes the
+  // start of slice 'g' of the counts
+  guide_.assign(kGuideSize, 0);
+  int sub = 0;
+  for (int slice = 0; slice < kGuideSize; ++slice) {
+    LONG slice_start = static_cast<LONG>(slice) * total_count_ / kGuideSize;
+    while (cumulative_count_.at(sub) <= slice_start) {
+      ++sub;
+    }
+    guide_.at(slice) = static_cast<uint16_t>(sub);
+  }
+
+  int columns = static_cast<int>(distinct_value_.size());
+  vector<LONG> units(columns);
+  vector<int> small;
+  vector<int> large;
+  for (int column = 0; column < columns; ++column) {
+    units.at(column) = occurrences[distinct_value_.at(column)] * columns;
+    if (units.at(column) < total_count_) {
+      small.push_back(column);
+    } else {
+      large.push_back(column);
+    }
+  }
+
+  alias_threshold_.assign(columns, 0xFFFFFFFFu);
+  column_value_ = distinct_value_;
+  alias_value_ = distinct_value_;
+  while (!small.empty() && !large.empty()) {
+    int little = small.back();
+    small.pop_back();
+    int big = large.back();
+
+    // 'little' keeps its own units and borrows the rest from 'big'
+    alias_threshold_.at(little) = static_cast<uint32_t>(
+        (units.at(little) << 32) / total_count_);
+    alias_value_.at(little) = distinct_value_.at(big);
+    units.at(big) -= total_count_ - units.at(little);
+    if (units.at(big) < total_count_) {
+      large.pop_back();
+      small.push_back(big);
+    }
+  }
+  // whatever is left is full to within rounding and keeps its own value
+}
+
+/****************************************************************
+* Function 'Draw'
+*
+* Fills 'out' with 'count' times drawn from the measured times.  Each
+* draw takes one 32-bit random number: the high half of its product
+* with the number of columns picks the column and the low half is
+* compared with the column's threshold, a select rather than a branch.
+* The probabilities are exact to within one part in 2^32 / columns.
+*
+* Parameters:
+*    random - the random stream to draw from
+*    count - how many times to draw
+*    out - where to put them
+**/
+void ServiceTable::Draw(MyRandom& random, int count, int *out) const {
+  uint32_t *bits = reinterpret_cast<uint32_t *>(out);
+  random.FillBits(count, bits);
+
+  uint64_t columns = alias_threshold_.size();
+  const uint32_t *threshold = alias_threshold_.data();
+  const uint16_t *own_value = column_value_.data();
+  const uint16_t *other_value = alias_value_.data();
+  for (int sub = 0; sub < count; ++sub) {
+    uint64_t product = bits[sub] * columns;
+    uint32_t column = static_cast<uint32_t>(product >> 32);
+    uint32_t fraction = static_cast<uint32_t>(product);
+    out[sub] = (fraction < threshold[column]) ? own_value[column]
+                                              : other_value[column];
+  }
+}
+
+/****************************************************************
+* Function 'DrawAntithetic'
+*
+* Fills 'out' with antithetic pairs: each pair is the quantiles at u
+* and at 1 - u for one random u, so a long time in a pair is matched
+* by a short one.  An odd last time is an ordinary quantile draw.
+*
+* Parameters:
+*    random - the random stream to draw from
+*    count - how many times to draw
+*    out - where to put them
+**/
+void ServiceTable::DrawAntithetic(MyRandom& random, int count,
+                                  int *out) const {
+  uint32_t *bits = reinterpret_cast<uint32_t *>(out);
+  random.FillBits((count + 1) / 2, bits);
+
+  // work from the top down so no bits are overwritten before use
+  for (int sub = count - 1; sub >= 0; --sub) {
+    uint32_t fraction = bits[sub / 2];
+    if (1 == sub % 2) {
+      fraction = ~fraction;
+    }
+    out[sub] = this->Quantile(fraction);
+  }
+}
+
+/****************************************************************
+* Function 'DrawStratified'
+*
+* Fills 'out' with one time from each of 'count' equal slices of
+* probability, then shuffles them so that the slice a voter's time
+* came from has nothing to do with the voter's place in line.
+*
+* Parameters:
+*    random - the random stream to draw from
+*    count - how many times to draw
+*    out - where to put them
+**/
+void ServiceTable::DrawStratified(MyRandom& random, int count,
+                                  int *out) const {
+  if (count <= 0) {
+    return;
+  }
+  uint32_t *bits = reinterpret_cast<uint32_t *>(out);
+  random.FillBits(count, bits);
+  for (int sub = 0; sub < count; ++sub) {
+    uint64_t within = (static_cast<uint64_t>(sub) << 32) | bits[sub];
+    out[sub] = this->Quantile(static_cast<uint32_t>(within / count));
+  }
+
+  // Fisher-Yates, with the random numbers drawn a chunk at a time
+  const int kChunk = 64;
+  uint32_t shuffle_bits[kChunk];
+  int used = kChunk;
+  for (int sub = count - 1; sub > 0; --sub) {
+    if (used >= kChunk) {
+      random.FillBits(kChunk, shuffle_bits);
+      used = 0;
+    }
+    uint64_t product = static_cast<uint64_t>(shuffle_bits[used++])
+                     * static_cast<uint64_t>(sub + 1);
+    int other = static_cast<int>(product >> 32);
+    int temp = out[sub];
+    out[sub] = out[other];
+    out[other] = temp;
+  }
+}
+
+/****************************************************************
+* Function 'Quantile'
+*
+* Returns the measured time at a given fraction of the way through the
+* sorted times, exactly as a subscript into the sorted file would.
+*
+* Parameters:
+*    fraction - the fraction, scaled so that 2^32 is the whole
+*
+* Returns:
+*    the time in seconds
+**/
+int ServiceTable::Quantile(uint32_t fraction) const {
+  uint32_t rank = static_cast<uint32_t>(
+      (static_cast<uint64_t>(fraction) * total_count_) >> 32);
+  int sub = guide_[static_cast<uint64_t>(rank) * kGuideSize / total_count_];
+  while (cumulative_count_[sub] <= rank) {
+    ++sub;
+  }
+  return distinct_value_[sub];
+}
+
+/****************************************************************
+* Usual 'ToString'.
+**/
+string ServiceTable::ToString() const {
+  string s = "";
+
+  s += kTag + "service times " + Utils::Format(total_count_, 8)
+     + " distinct " + Utils::Format(this->GetDistinctCount(), 6)
+     + " table bytes "
+     + Utils::Format(static_cast<int>(alias_threshold_.size() * 8
+                                      + cumulative_count_.size() * 6
+                                      + guide_.size() * 2), 8)
+     + "\n";
+
+  return s;
+}
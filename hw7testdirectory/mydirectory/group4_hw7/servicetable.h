@@ -0,0 +1,70 @@
+/****************************************************************
+ * Header for the 'ServiceTable' class.
+ * A compact table for drawing voting (service) times from the
+ * measured times in the service time data file.
+ *
+ * Author/copyright:  Duncan Buell
+ * Used with permission and modified by: Group 4
+ *                                       Erik Akeyson
+ *                                       Matthew Clapp
+ *                                       Harrison Goodman
+ *                                       Andy Michels
+ *                                       Steve Smero
+ * Date: 1 December 2016
+ *
+**/
+
+#ifndef SERVICETABLE_H
+#define SERVICETABLE_H
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+#include "../Utilities/utils.h"
+
+using namespace std;
+
+#include "myrandom.h"
+
+class ServiceTable {
+public:
+/****************************************************************
+ * Constructors and destructors for the class.
+**/
+ ServiceTable();
+ virtual ~ServiceTable();
+
+/****************************************************************
+ * Accessors and Mutators.
+**/
+ int GetDistinctCount() const;
+
+/****************************************************************
+ * General functions.
+**/
+ void Build(const vector<int>& service_times);
+ void Draw(MyRandom& random, int count, int *out) const;
+ void DrawAntithetic(MyRandom& random, int count, int *out) const;
+ void DrawStratified(MyRandom& random, int count, int *out) const;
+ int Quantile(uint32_t fraction) const;
+
+ string ToString() const;
+
+private:
+ static const int kGuideSize = 1024;
+
+ uint32_t total_count_ = 0;
+
+ // alias table, one column per distinct time
+ vector<uint32_t> alias_threshold_;
+ vector<uint16_t> alias_value_;
+ vector<uint16_t> column_value_;
+
+ // inverse distribution function over the distinct times
+ vector<uint32_t> cumulative_count_;
+ vector<uint16_t> distinct_value_;
+ vector<uint16_t> guide_;
+};
+
+#endif // SERVICETABLE_H
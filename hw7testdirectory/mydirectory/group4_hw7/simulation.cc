@@ -45,22 +45,83 @@ void Simulation::ReadPrecincts(Scanner& infile) {
     pcts_[new_pct.GetPctNumber()] = new_pct;
   } // while (infile.HasNext()) {
 } // void Simulation::ReadPrecincts(Scanner& infile) {
+
+/****************************************************************
+* Function 'ReadPrecincts'
+* The same, from a binary precinct table.  Each precinct is read into
+* its place in the map rather than copied there.
+**/
+void Simulation::ReadPrecincts(const PctTable& table) {
+  for (int row = 0; row < table.GetCount(); ++row) {
+    pcts_[table.GetNumber(row)].ReadData(table, row);
+  }
+} // void Simulation::ReadPrecincts(const PctTable& table) {
+/****************************************************************
+* Function 'RunApproximation'
+*
+* Parameters:
+*     config - The configuration
+*     output - The buffered output and log files
+*
+* Runs the fluid approximation in place of the simulation for every
+* precinct in the range of expected voters that 'RunSimulation' would
+* simulate.  There is nothing random and no iterations, so the whole
+* set of precincts takes a moment and is done in this thread.
+**/
+void Simulation::RunApproximation(const Configuration& config,
+                                  BufferedOutput& output) {
+  string outstring = "XX";
+  int pct_count_this_batch = 0;
+  for (auto iterPct = pcts_.begin(); iterPct != pcts_.end(); ++iterPct) {
+    OnePct& pct = iterPct->second;
+    int expected_voters = pct.GetExpectedVoters();
+    if ((expected_voters <=  config.min_expected_to_simulate_) ||
+        (expected_voters >   config.max_expected_to_simulate_)) {
+      continue;
+    }
+
+    ostringstream pct_stream;
+    pct_stream << kTag << "RunApproximation for pct " << "\n";
+    pct_stream << kTag << pct.ToString() << "\n";
+    pct.RunFluidPct(config, pct_stream);
+    output.Write(pct_stream.str());
+    output.EndPrecinct();
+    ++pct_count_this_batch;
+  }
+
+  outstring = kTag + "PRECINCT COUNT THIS BATCH "
+            + Utils::Format(pct_count_this_batch, 4) + "\n";
+  output.Write(outstring);
+} // void Simulation::RunApproximation(const Configuration& config, ...)
+
 /****************************************************************
 * Function 'Run Simulation'
 *
 * Parameters:
 *     config -
 *     random - An instance of a MyRandom class
-*     out_stream - The output stream 
+*     output - The buffered output and log files
 * 
 * This function iterates threw the map of OnePct and its going to get each 
 * expected voter for each pct. It does checking to make sure it is not
 * less than that minimum expected and larger than the expected maximum.
+*
+* Each precinct's output is written as one block, in order of precinct
+* number, and each block is followed by 'EndPrecinct' for the flush
+* policy.  With no thread count configured the precincts are run one
+* after the other; otherwise they are run by 'RunSimulationThreads'.
+* Either way each precinct draws from its own random streams, so the
+* output is the same.
+*
+* Returns:
+*     false if the 'verify' engine found the two engines disagreeing;
+*     this is written to the output once every precinct has finished,
+*     and stopping the program is left to the caller
 **/
-void Simulation::RunSimulation(const Configuration& config,
-                               MyRandom& random, ofstream& out_stream) {
+bool Simulation::RunSimulation(const Configuration& config,
+                               MyRandom& random, BufferedOutput& output) {
   string outstring = "XX";
-  int pct_count_this_batch = 0;
+  vector<OnePct> pcts_to_run;
   for (auto iterPct = pcts_.begin(); iterPct != pcts_.end(); ++iterPct) {
     OnePct pct = iterPct->second;
     int expected_voters = pct.GetExpectedVoters();
@@ -68,27 +129,148 @@ void Simulation::RunSimulation(const Configuration& config,
         (expected_voters >   config.max_expected_to_simulate_)) {
       continue;
     }
+    pcts_to_run.push_back(pct);
+  } // for(auto iterPct = pcts_.begin(); iterPct != pcts_.end(); ++iterPct)
 
-    outstring = kTag + "RunSimulation for pct " + "\n";
-    outstring += kTag + pct.ToString() + "\n";
-    Utils::Output(outstring, out_stream, Utils::log_stream);
+  if (config.thread_count_ > 0) {
+    this->RunSimulationThreads(config, pcts_to_run, output);
+  } else {
+    for (auto iterPct = pcts_to_run.begin();
+         iterPct != pcts_to_run.end(); ++iterPct) {
+      outstring = this->RunOnePct(config, random, *iterPct);
+      output.Write(outstring);
+      output.EndPrecinct();
+    }
+  }
 
-    ++pct_count_this_batch;
-    pct.RunSimulationPct(config, random, out_stream);
+  // the 'verify' engine only records a disagreement, since it may be
+  // found on a worker thread, and by now all the workers are done
+  string mismatches = "";
+  for (auto iterPct = pcts_to_run.begin();
+       iterPct != pcts_to_run.end(); ++iterPct) {
+    mismatches += iterPct->GetEngineMismatch();
+  }
+  if (!mismatches.empty()) {
+    cout << mismatches;
+    output.Write(mismatches);
+    return false;
+  }
 
-    //    break; // we only run one pct right now
-  } // for(auto iterPct = pcts_.begin(); iterPct != pcts_.end(); ++iterPct)
+  int pct_count_this_batch = static_cast<int>(pcts_to_run.size());
 
   outstring = kTag + "PRECINCT COUNT THIS BATCH "
             + Utils::Format(pct_count_this_batch, 4) + "\n";
-  //  Utils::Output(outstring, out_stream);
-  Utils::Output(outstring, out_stream, Utils::log_stream);
-  //out_stream << outstring << endl;
-  //out_stream.flush();
-  //Utils::log_stream << outstring << endl;
-  //Utils::log_stream.flush();
-
-} // void Simulation::RunSimulation()
+  output.Write(outstring);
+
+  // the buffers are reserved once per precinct, so the iterations
+  // themselves should never touch the heap; this goes to the log and
+  // the console only, like the scheduler's report
+  LONG allocations_reserving = 0;
+  LONG allocations_simulating = 0;
+  LONG iterations_run = 0;
+  for (auto iterPct = pcts_to_run.begin();
+       iterPct != pcts_to_run.end(); ++iterPct) {
+    allocations_reserving += iterPct->GetAllocationsReserving();
+    allocations_simulating += iterPct->GetAllocationsSimulating();
+    iterations_run += iterPct->GetIterationsRun();
+  }
+  outstring = kTag + "heap allocations reserving "
+            + Utils::Format(allocations_reserving, 8) + " simulating "
+            + Utils::Format(allocations_simulating, 8) + " in "
+            + Utils::Format(iterations_run, 8) + " iterations\n";
+  cout << outstring;
+  output.WriteLog(outstring);
+
+  return true;
+} // bool Simulation::RunSimulation()
+
+/****************************************************************
+* Function 'RunOnePct'
+*
+* Simulates one precinct and returns everything it would print.
+*
+* Parameters:
+*     config - The configuration
+*     random - The random stream for this precinct
+*     pct - The precinct to simulate
+*
+* Returns:
+*     the output block for the precinct
+**/
+string Simulation::RunOnePct(const Configuration& config, MyRandom& random,
+                             OnePct& pct) {
+  ostringstream pct_stream;
+
+  pct_stream << kTag << "RunSimulation for pct " << "\n";
+  pct_stream << kTag << pct.ToString() << "\n";
+  pct.RunSimulationPct(config, random, pct_stream);
+
+  return pct_stream.str();
+} // string Simulation::RunOnePct(const Configuration& config, ...)
+
+/****************************************************************
+* Function 'RunSimulationThreads'
+*
+* Runs the precincts on 'config.thread_count_' threads through a
+* work-stealing 'PctScheduler', largest estimated cost first, so the
+* big precincts are not left until the end.  Every precinct has its
+* own random streams, chosen by the seed and the precinct number, so
+* the results do not depend on which thread ran it or when.  This
+* thread writes each finished block as soon as all the blocks before
+* it have been written, which keeps the output identical for any
+* thread count.  How busy each worker was goes to the log and the
+* console only, since it changes from run to run.
+*
+* Parameters:
+*     config - The configuration
+*     pcts_to_run - The precincts to simulate, in precinct number order
+*     output - The buffered output and log files
+**/
+void Simulation::RunSimulationThreads(const Configuration& config,
+                                      vector<OnePct>& pcts_to_run,
+                                      BufferedOutput& output) {
+  int pct_count = static_cast<int>(pcts_to_run.size());
+  vector<string> blocks(pct_count);
+  vector<bool> block_done(pct_count, false);
+  mutex lock;
+  condition_variable block_finished;
+
+  vector<LONG> costs;
+  for (auto iterPct = pcts_to_run.begin();
+       iterPct != pcts_to_run.end(); ++iterPct) {
+    costs.push_back(iterPct->GetEstimatedCost(config));
+  }
+
+  PctScheduler scheduler(config.thread_count_);
+  scheduler.Start(costs, [&](int which) {
+    OnePct& pct = pcts_to_run.at(which);
+    MyRandom random(config.seed_, pct.GetPctNumber());
+    string block = this->RunOnePct(config, random, pct);
+
+    lock_guard<mutex> guard(lock);
+    blocks.at(which).swap(block);
+    block_done.at(which) = true;
+    block_finished.notify_all();
+  });
+
+  for (int which = 0; which < pct_count; ++which) {
+    string block;
+    {
+      unique_lock<mutex> guard(lock);
+      while (!block_done.at(which)) {
+        block_finished.wait(guard);
+      }
+      block.swap(blocks.at(which));
+    }
+    output.Write(block);
+    output.EndPrecinct();
+  }
+
+  scheduler.Wait();
+  string outstring = scheduler.ToStringBusy();
+  cout << outstring;
+  output.WriteLog(outstring);
+} // void Simulation::RunSimulationThreads(const Configuration& config, ...)
 
 /****************************************************************
 * Usual 'ToString'.
@@ -17,9 +17,13 @@
 #ifndef SIMULATION_H
 #define SIMULATION_H
 
+#include <condition_variable>
 #include <map>
+#include <mutex>
+#include <vector>
 
 #include "../Utilities/utils.h"
+#include "../Utilities/bufferedoutput.h"
 #include "../Utilities/scanner.h"
 #include "../Utilities/scanline.h"
 
@@ -27,6 +31,7 @@ using namespace std;
 
 #include "configuration.h"
 #include "onepct.h"
+#include "pctscheduler.h"
 
 class Simulation
 {
@@ -41,8 +46,10 @@ public:
  * General functions.
 **/
   void ReadPrecincts(Scanner& infile);
-  void RunSimulation(const Configuration& config,
-                     MyRandom& random, ofstream& out_stream);
+  void ReadPrecincts(const PctTable& table);
+  void RunApproximation(const Configuration& config, BufferedOutput& output);
+  bool RunSimulation(const Configuration& config,
+                     MyRandom& random, BufferedOutput& output);
   string ToString();
   string ToStringPcts();
 
@@ -55,6 +62,11 @@ private:
 /****************************************************************
  * Private functions.
 **/
+  string RunOnePct(const Configuration& config, MyRandom& random,
+                   OnePct& pct);
+  void RunSimulationThreads(const Configuration& config,
+                            vector<OnePct>& pcts_to_run,
+                            BufferedOutput& output);
 };
 
 #endif // SIMULATION_H
@@ -0,0 +1,154 @@
+#include "waitsketch.h"
+/****************************************************************
+ * Implementation for the 'WaitSketch' class.
+ * Sorting every wait to find its percentiles costs too much, so the
+ * waits are counted in log-linear buckets in the manner of an HDR
+ * histogram: one bucket per second for short waits, then, for each
+ * doubling of the wait, 2^kSubBits buckets of equal width.  A bucket
+ * is never wider than one part in 2^kSubBits of the waits it holds,
+ * so a percentile read from the buckets is that close to the truth.
+ *
+ * The buckets are a fixed array, so a sketch never allocates, and two
+ * sketches of any waits at all merge exactly by adding their arrays,
+ * whether they come from different iterations, threads, or runs.
+ *
+ * Author/copyright:  Duncan Buell. All rights reserved.
+ * Used with permission and modified by: Group 4
+ *                                       Erik Akeyson
+ *                                       Matthew Clapp
+ *                                       Harrison Goodman
+ *                                       Andy Michels
+ *                                       Steve Smero
+ * Date: 1 December 2016
+**/
+
+static const string kTag = "WAITSKETCH: ";
+
+/****************************************************************
+* Constructor.
+**/
+WaitSketch::WaitSketch() {
+  for (int bucket = 0; bucket < kBucketCount; ++bucket) {
+    counts_[bucket] = 0;
+  }
+}
+
+/****************************************************************
+* Destructor.
+**/
+WaitSketch::~WaitSketch() {
+}
+
+/****************************************************************
+* Accessors and mutators.
+**/
+/****************************************************************
+**/
+LONG WaitSketch::GetCount() const {
+  return count_;
+}
+
+/****************************************************************
+* Returns:
+*    the longest wait, exactly
+**/
+int WaitSketch::GetMax() const {
+  return max_seconds_;
+}
+
+/****************************************************************
+* Returns the wait that 'fraction' of the waits are no longer than,
+* rounded up to the top of its bucket but never past the longest wait.
+*
+* Parameters:
+*    fraction - the percentile as a fraction, as 0.9 for P90
+*
+* Returns:
+*    the wait in seconds, or 0 if there are no waits
+**/
+int WaitSketch::GetPercentile(double fraction) const {
+  if (0 == count_) {
+    return 0;
+  }
+  LONG rank = static_cast<LONG>(ceil(fraction * static_cast<double>(count_)));
+  if (rank < 1) {
+    rank = 1;
+  }
+
+  LONG seen = 0;
+  for (int bucket = 0; bucket <= max_bucket_; ++bucket) {
+    seen += counts_[bucket];
+    if (seen >= rank) {
+      int top = GetBucketTop(bucket);
+      return (top < max_seconds_) ? top : max_seconds_;
+    }
+  }
+  return max_seconds_;
+}
+
+/****************************************************************
+* Returns:
+*    the longest wait that is counted in 'bucket'
+**/
+int WaitSketch::GetBucketTop(int bucket) {
+  if (bucket < (1 << kSubBits)) {
+    return bucket;
+  }
+  int shift = (bucket >> kSubBits) - 1;
+  LONG lead = (bucket & ((1 << kSubBits) - 1)) + (1 << kSubBits);
+  return static_cast<int>(((lead + 1) << shift) - 1);
+}
+
+/****************************************************************
+* General functions.
+**/
+/****************************************************************
+* Function 'Clear'
+*
+* Forgets all the waits, touching only the buckets that may be in use.
+**/
+void WaitSketch::Clear() {
+  for (int bucket = 0; bucket <= max_bucket_; ++bucket) {
+    counts_[bucket] = 0;
+  }
+  max_bucket_ = -1;
+  max_seconds_ = 0;
+  count_ = 0;
+}
+
+/****************************************************************
+* Function 'Merge'
+*
+* Adds the waits of another sketch to this one.  This is exact: the
+* result is the sketch of all the waits of both.
+*
+* Parameters:
+*    that - the sketch to add in
+**/
+void WaitSketch::Merge(const WaitSketch& that) {
+  for (int bucket = 0; bucket <= that.max_bucket_; ++bucket) {
+    counts_[bucket] += that.counts_[bucket];
+  }
+  if (that.max_bucket_ > max_bucket_) {
+    max_bucket_ = that.max_bucket_;
+  }
+  if (that.max_seconds_ > max_seconds_) {
+    max_seconds_ = that.max_seconds_;
+  }
+  count_ += that.count_;
+}
+
+/****************************************************************
+* Usual 'ToString', with the waits in minutes.
+**/
+string WaitSketch::ToString() const {
+  string s = "";
+
+  s += kTag + "count " + Utils::Format(count_, 8)
+     + " P50 " + Utils::Format(this->GetPercentile(0.50) / 60.0, 8, 2)
+     + " P90 " + Utils::Format(this->GetPercentile(0.90) / 60.0, 8, 2)
+     + " P99 " + Utils::Format(this->GetPercentile(0.99) / 60.0, 8, 2)
+     + " max " + Utils::Format(max_seconds_ / 60.0, 8, 2) + "\n";
+
+  return s;
+}
@@ -0,0 +1,91 @@
+/****************************************************************
+ * Header for the 'WaitSketch' class.
+ * A fixed-size sketch of the distribution of wait times, in seconds,
+ * from which percentiles can be read to within a small relative error.
+ *
+ * Author/copyright:  Duncan Buell
+ * Used with permission and modified by: Group 4
+ *                                       Erik Akeyson
+ *                                       Matthew Clapp
+ *                                       Harrison Goodman
+ *                                       Andy Michels
+ *                                       Steve Smero
+ * Date: 1 December 2016
+ *
+**/
+
+#ifndef WAITSKETCH_H
+#define WAITSKETCH_H
+
+#include <cmath>
+#include <cstdint>
+
+#include "../Utilities/utils.h"
+
+using namespace std;
+
+class WaitSketch {
+public:
+/****************************************************************
+ * Constructors and destructors for the class.
+**/
+ WaitSketch();
+ virtual ~WaitSketch();
+
+/****************************************************************
+ * Accessors and Mutators.
+**/
+ LONG GetCount() const;
+ int GetMax() const;
+ int GetPercentile(double fraction) const;
+
+/****************************************************************
+ * General functions.
+**/
+ void Clear();
+ void Merge(const WaitSketch& that);
+
+/****************************************************************
+ * Counts one wait.  This is called for every voter, so it is here
+ * in the header where it can be inlined.  Waits below 2^(kSubBits + 1)
+ * are counted exactly; above that, each doubling of the wait is split
+ * into 2^kSubBits buckets, picked by the leading bits of the wait.
+**/
+ void Add(int seconds) {
+   uint32_t value = static_cast<uint32_t>(seconds);
+   int bucket = static_cast<int>(value);
+   if (value >= (1u << kSubBits)) {
+     int top_bit = 31 - __builtin_clz(value);
+     int shift = top_bit - kSubBits;
+     bucket = ((shift + 1) << kSubBits)
+            + static_cast<int>((value >> shift) - (1u << kSubBits));
+   }
+   ++counts_[bucket];
+   if (bucket > max_bucket_) {
+     max_bucket_ = bucket;
+   }
+   if (seconds > max_seconds_) {
+     max_seconds_ = seconds;
+   }
+   ++count_;
+ }
+
+ string ToString() const;
+
+ // buckets per doubling, as a power of two; percentiles are within
+ // one part in 2^kSubBits
+ static const int kSubBits = 6;
+ static const int kBucketCount = (32 - kSubBits) << kSubBits;
+
+private:
+ uint32_t counts_[kBucketCount];
+ LONG count_ = 0;
+
+ // all buckets past this one are zero
+ int max_bucket_ = -1;
+ int max_seconds_ = 0;
+
+ static int GetBucketTop(int bucket);
+};
+
+#endif // WAITSKETCH_H
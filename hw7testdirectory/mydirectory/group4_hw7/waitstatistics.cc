@@ -0,0 +1,168 @@
+#include "waitstatistics.h"
+/****************************************************************
+ * Implementation for the 'WaitStatistics' class.
+ * The queue engines hand each voter's wait to 'Add' as the voter
+ * starts voting.  Everything 'OnePct' reports about an iteration, the
+ * mean and deviation of the waits, the counts of voters who waited too
+ * long, and the counts by minute for the histogram, is kept as it
+ * goes, so the memory used does not grow with the number of voters.
+ *
+ * Author/copyright:  Duncan Buell. All rights reserved.
+ * Used with permission and modified by: Group 4
+ *                                       Erik Akeyson
+ *                                       Matthew Clapp
+ *                                       Harrison Goodman
+ *                                       Andy Michels
+ *                                       Steve Smero
+ * Date: 1 December 2016
+**/
+
+static const string kTag = "WAITSTATS: ";
+
+/****************************************************************
+* Constructor.
+**/
+WaitStatistics::WaitStatistics() {
+}
+
+/****************************************************************
+* Destructor.
+**/
+WaitStatistics::~WaitStatistics() {
+}
+
+/****************************************************************
+* Accessors and mutators.
+**/
+/****************************************************************
+**/
+LONG WaitStatistics::GetCount() const {
+  return count_;
+}
+
+/****************************************************************
+* Number of voters who waited more than 'too long' (which is 0), 10
+* minutes more (which is 1), or 20 minutes more (which is 2).
+**/
+int WaitStatistics::GetCountTooLong(int which) const {
+  return too_long_counts_[which];
+}
+
+/****************************************************************
+**/
+double WaitStatistics::GetMeanSeconds() const {
+  return mean_seconds_;
+}
+
+/****************************************************************
+* Returns:
+*    the sketch of the waits of the voters who arrived in 'hour'
+**/
+const WaitSketch& WaitStatistics::GetHourSketch(int hour) const {
+  return hour_sketches_.at(hour);
+}
+
+/****************************************************************
+* Returns:
+*    the number of hours with sketches, 0 if none are being kept
+**/
+int WaitStatistics::GetHours() const {
+  return hours_;
+}
+
+/****************************************************************
+* Returns:
+*    the voters counted by whole minutes waited
+**/
+const Histogram& WaitStatistics::GetMinutes() const {
+  return minutes_;
+}
+
+/****************************************************************
+**/
+double WaitStatistics::GetSumOfSquaredDeviations() const {
+  return sum_squared_deviations_;
+}
+
+/****************************************************************
+**/
+LONG WaitStatistics::GetSumSeconds() const {
+  return sum_seconds_;
+}
+
+/****************************************************************
+* General functions.
+**/
+/****************************************************************
+* Function 'SetHours'
+*
+* Starts or stops keeping a sketch of the waits for each hour of the
+* day, from which the percentiles of the waits can be read.  This also
+* forgets any waits already added to the sketches.
+*
+* Parameters:
+*    hours - the hours in the day, or 0 to keep no sketches
+**/
+void WaitStatistics::SetHours(int hours) {
+  hours_ = hours;
+  hour_sketches_.assign(hours, WaitSketch());
+}
+
+/****************************************************************
+* Function 'SetMaxMinutes'
+*
+* Sizes the counts by minute for waits of up to 'minutes'; longer
+* waits are counted together in the overflow bin.  This also forgets
+* any waits already added.
+**/
+void WaitStatistics::SetMaxMinutes(int minutes) {
+  minutes_.SetBinCount(minutes + 1);
+}
+
+/****************************************************************
+* Function 'Reset'
+*
+* Forgets all the waits added so far, keeping the space for the
+* counts by minute.
+*
+* Parameters:
+*    too_long_minutes - a wait of more than this many whole minutes
+*                       is too long
+**/
+void WaitStatistics::Reset(int too_long_minutes) {
+  minutes_.Clear();
+  for (int hour = 0; hour < hours_; ++hour) {
+    hour_sketches_[hour].Clear();
+  }
+  count_ = 0;
+  sum_seconds_ = 0;
+  mean_seconds_ = 0.0;
+  sum_squared_deviations_ = 0.0;
+  for (int which = 0; which < kTooLongLevels; ++which) {
+    too_long_counts_[which] = 0;
+    too_long_minutes_[which] = too_long_minutes + 10 * which;
+  }
+}
+
+/****************************************************************
+* Usual 'ToString'.
+**/
+string WaitStatistics::ToString() const {
+  string s = "";
+
+  s += kTag + "voters " + Utils::Format(count_, 8)
+     + " mean/dev wait (mins) "
+     + Utils::Format(mean_seconds_ / 60.0, 8, 2) + " ";
+  double dev_seconds = 0.0;
+  if (count_ > 0) {
+    dev_seconds = sqrt(sum_squared_deviations_
+                       / static_cast<double>(count_));
+  }
+  s += Utils::Format(dev_seconds / 60.0, 8, 2) + " toolong";
+  for (int which = 0; which < kTooLongLevels; ++which) {
+    s += " " + Utils::Format(too_long_counts_[which], 6);
+  }
+  s += "\n";
+
+  return s;
+}
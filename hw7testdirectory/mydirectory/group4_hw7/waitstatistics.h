@@ -0,0 +1,113 @@
+/****************************************************************
+ * Header for the 'WaitStatistics' class.
+ * Running statistics of the voters' wait times, taken one voter at a
+ * time as each starts voting, so that no voter need be kept after.
+ *
+ * Author/copyright:  Duncan Buell
+ * Used with permission and modified by: Group 4
+ *                                       Erik Akeyson
+ *                                       Matthew Clapp
+ *                                       Harrison Goodman
+ *                                       Andy Michels
+ *                                       Steve Smero
+ * Date: 1 December 2016
+ *
+**/
+
+#ifndef WAITSTATISTICS_H
+#define WAITSTATISTICS_H
+
+#include <cmath>
+#include <vector>
+
+#include "../Utilities/utils.h"
+
+using namespace std;
+
+#include "histogram.h"
+#include "waitsketch.h"
+
+class WaitStatistics {
+public:
+/****************************************************************
+ * Constructors and destructors for the class.
+**/
+ WaitStatistics();
+ virtual ~WaitStatistics();
+
+/****************************************************************
+ * Accessors and Mutators.
+**/
+ LONG GetCount() const;
+ int GetCountTooLong(int which) const;
+ double GetMeanSeconds() const;
+ const WaitSketch& GetHourSketch(int hour) const;
+ int GetHours() const;
+ const Histogram& GetMinutes() const;
+ double GetSumOfSquaredDeviations() const;
+ LONG GetSumSeconds() const;
+
+/****************************************************************
+ * General functions.
+**/
+ void SetHours(int hours);
+ void SetMaxMinutes(int minutes);
+ void Reset(int too_long_minutes);
+
+/****************************************************************
+ * Adds one voter's wait.  This is called for every voter, so it is
+ * here in the header where the queue engines can inline it.  If
+ * percentiles are being kept, the wait also goes into the sketch for
+ * the hour of the voter's arrival, late arrivals counting in the last
+ * hour.  The mean and the sum of squared deviations from it are
+ * updated by Welford's method, which does not lose precision as the
+ * sum of squares of the waits would.  The sum of the waits is also
+ * kept exactly, in 64 bits.
+**/
+ void Add(int wait_seconds, int arrival_seconds) {
+   ++count_;
+   sum_seconds_ += wait_seconds;
+   double delta = static_cast<double>(wait_seconds) - mean_seconds_;
+   mean_seconds_ += delta / static_cast<double>(count_);
+   sum_squared_deviations_ += delta * (static_cast<double>(wait_seconds)
+                                       - mean_seconds_);
+
+   int minutes = wait_seconds / 60;
+   minutes_.Add(minutes);
+
+   if (hours_ > 0) {
+     int hour = arrival_seconds / 3600;
+     if (hour >= hours_) {
+       hour = hours_ - 1;
+     }
+     hour_sketches_[hour].Add(wait_seconds);
+   }
+
+   for (int which = 0; which < kTooLongLevels; ++which) {
+     too_long_counts_[which] += (minutes > too_long_minutes_[which]);
+   }
+ }
+
+ string ToString() const;
+
+ // 'too long', 10 minutes past it, and 20 minutes past it
+ static const int kTooLongLevels = 3;
+
+private:
+ LONG count_ = 0;
+ LONG sum_seconds_ = 0;
+ double mean_seconds_ = 0.0;
+ double sum_squared_deviations_ = 0.0;
+
+ // voters by whole minutes waited
+ Histogram minutes_;
+
+ // sketches of the waits by hour of arrival, if 'hours_' is not 0
+ int hours_ = 0;
+ vector<WaitSketch> hour_sketches_;
+
+ int too_long_counts_[kTooLongLevels] = {0, 0, 0};
+ int too_long_minutes_[kTooLongLevels] = {0, 0, 0};
+};
+
+#endif // WAITSTATISTICS_H